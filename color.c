@@ -28,6 +28,7 @@
 
 #include "config.h"
 #include <assert.h>
+#include <ctype.h>
 #include <regex.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -61,8 +62,29 @@ struct ColorLineHead ColorIndexSubjectList = STAILQ_HEAD_INITIALIZER(ColorIndexS
 struct ColorLineHead ColorIndexTagList = STAILQ_HEAD_INITIALIZER(ColorIndexTagList);
 struct ColorLineHead ColorStatusList = STAILQ_HEAD_INITIALIZER(ColorStatusList);
 
+/**
+ * struct ColorMatcher - Find the literals of many colour patterns in one pass
+ *
+ * An Aho-Corasick automaton built from the ColorLine::literal of every pattern
+ * in a list.  It's case-insensitive, so it may let through a case-sensitive
+ * pattern that can't match, but it never rules out one that can.
+ */
+struct ColorMatcher
+{
+  bool valid;                 ///< Automaton matches the list
+  int num_classes;            ///< Number of byte classes, including 0
+  unsigned char classes[256]; ///< Byte to class; 0 for bytes not in any literal
+  int *delta;                 ///< Transitions: [state * num_classes + class]
+  int *output;                ///< First rule whose literal ends at each state, or -1
+  int *dict;                  ///< Nearest suffix state with an output, or -1
+  int *next;                  ///< Next rule with the same literal, or -1
+  struct ColorLine **rules;   ///< Rules with a literal, indexed by rule number
+};
+
 /* local to this file */
 static int ColorQuoteSize;
+static struct ColorMatcher BodyMatcher;
+static struct ColorMatcher HdrMatcher;
 
 #ifdef HAVE_COLOR
 
@@ -199,9 +221,252 @@ static void free_color_line(struct ColorLine *tmp, bool free_colors)
   regfree(&tmp->regex);
   mutt_pattern_free(&tmp->color_pattern);
   FREE(&tmp->pattern);
+  FREE(&tmp->literal);
   FREE(&tmp);
 }
 
+/**
+ * pattern_is_context_free - Does a regex match the same text wherever a search starts?
+ * @param s Regular expression
+ * @retval true The regex has no anchors or word boundaries
+ *
+ * The pager searches a line from the end of the previous match.  A match of a
+ * context-free regex, found earlier in the line, is still the next match.
+ */
+static bool pattern_is_context_free(const char *s)
+{
+  for (; *s; s++)
+  {
+    if (*s == '^')
+      return false;
+    if (*s == '\\')
+    {
+      if (!s[1])
+        break;
+      if (strchr("<>bB`'", s[1]))
+        return false;
+      s++;
+    }
+  }
+  return true;
+}
+
+/**
+ * matcher_free - Free a ColorMatcher
+ * @param cm ColorMatcher to free
+ */
+static void matcher_free(struct ColorMatcher *cm)
+{
+  FREE(&cm->delta);
+  FREE(&cm->output);
+  FREE(&cm->dict);
+  FREE(&cm->next);
+  FREE(&cm->rules);
+  cm->valid = false;
+}
+
+/**
+ * matcher_build - Build a ColorMatcher from a list of colour patterns
+ * @param cm   ColorMatcher to fill
+ * @param head List of colour patterns
+ */
+static void matcher_build(struct ColorMatcher *cm, struct ColorLineHead *head)
+{
+  struct ColorLine *cl = NULL;
+  int num_rules = 0;
+  int max_states = 1;
+
+  matcher_free(cm);
+  memset(cm->classes, 0, sizeof(cm->classes));
+  cm->num_classes = 1;
+
+  STAILQ_FOREACH(cl, head, entries)
+  {
+    if (!cl->literal)
+      continue;
+    num_rules++;
+    for (const unsigned char *p = (unsigned char *) cl->literal; *p; p++)
+    {
+      max_states++;
+      if (cm->classes[*p] == 0)
+      {
+        cm->classes[tolower(*p)] = cm->num_classes;
+        cm->classes[toupper(*p)] = cm->num_classes;
+        cm->num_classes++;
+      }
+    }
+  }
+
+  cm->valid = true;
+  if (num_rules == 0)
+    return;
+
+  const int nc = cm->num_classes;
+  cm->delta = mutt_mem_malloc(max_states * nc * sizeof(int));
+  cm->output = mutt_mem_malloc(max_states * sizeof(int));
+  cm->dict = mutt_mem_malloc(max_states * sizeof(int));
+  cm->next = mutt_mem_malloc(num_rules * sizeof(int));
+  cm->rules = mutt_mem_malloc(num_rules * sizeof(struct ColorLine *));
+
+  /* Build a trie of the literals */
+  int num_states = 1;
+  memset(cm->delta, -1, nc * sizeof(int));
+  cm->output[0] = -1;
+
+  int rule = 0;
+  STAILQ_FOREACH(cl, head, entries)
+  {
+    if (!cl->literal)
+      continue;
+
+    int state = 0;
+    for (const unsigned char *p = (unsigned char *) cl->literal; *p; p++)
+    {
+      int *t = &cm->delta[state * nc + cm->classes[*p]];
+      if (*t == -1)
+      {
+        memset(&cm->delta[num_states * nc], -1, nc * sizeof(int));
+        cm->output[num_states] = -1;
+        *t = num_states++;
+      }
+      state = *t;
+    }
+
+    cm->rules[rule] = cl;
+    cm->next[rule] = cm->output[state];
+    cm->output[state] = rule;
+    rule++;
+  }
+
+  /* Breadth-first, turn the trie into an automaton */
+  int *fail = mutt_mem_malloc(num_states * sizeof(int));
+  int *queue = mutt_mem_malloc(num_states * sizeof(int));
+  int qhead = 0;
+  int qtail = 0;
+
+  cm->dict[0] = -1;
+  for (int c = 0; c < nc; c++)
+  {
+    int t = cm->delta[c];
+    if (t == -1)
+    {
+      cm->delta[c] = 0;
+    }
+    else
+    {
+      fail[t] = 0;
+      cm->dict[t] = -1;
+      queue[qtail++] = t;
+    }
+  }
+
+  while (qhead < qtail)
+  {
+    const int state = queue[qhead++];
+    for (int c = 0; c < nc; c++)
+    {
+      int *t = &cm->delta[state * nc + c];
+      const int f = cm->delta[fail[state] * nc + c];
+      if (*t == -1)
+      {
+        *t = f;
+      }
+      else
+      {
+        fail[*t] = f;
+        cm->dict[*t] = (cm->output[f] != -1) ? f : cm->dict[f];
+        queue[qtail++] = *t;
+      }
+    }
+  }
+
+  FREE(&fail);
+  FREE(&queue);
+}
+
+/**
+ * matcher_get - Get the ColorMatcher for a list of colour patterns
+ * @param head List of colour patterns
+ * @retval ptr  ColorMatcher
+ * @retval NULL The list doesn't have one
+ */
+static struct ColorMatcher *matcher_get(struct ColorLineHead *head)
+{
+  struct ColorMatcher *cm = NULL;
+
+  if (head == &ColorBodyList)
+    cm = &BodyMatcher;
+  else if (head == &ColorHdrList)
+    cm = &HdrMatcher;
+  else
+    return NULL;
+
+  if (!cm->valid)
+    matcher_build(cm, head);
+  return cm;
+}
+
+/**
+ * mutt_color_prefilter - Find the colour patterns that might match a string
+ * @param head List of colour patterns, e.g. #ColorBodyList
+ * @param str  String to be matched
+ *
+ * Set ColorLine::stop_matching for every pattern that can't match the string,
+ * because it doesn't contain the pattern's literal text.  The literals of all
+ * the patterns are found in a single pass over the string.
+ *
+ * This also forgets ColorLine::next_match, ready for matching a new string.
+ */
+void mutt_color_prefilter(struct ColorLineHead *head, const char *str)
+{
+  struct ColorLine *cl = NULL;
+  struct ColorMatcher *cm = matcher_get(head);
+
+  STAILQ_FOREACH(cl, head, entries)
+  {
+    cl->stop_matching = cm && cl->literal;
+    cl->next_match.rm_so = -1;
+  }
+
+  if (!cm || !cm->rules || !str)
+    return;
+
+  const int nc = cm->num_classes;
+  int state = 0;
+  for (const unsigned char *p = (const unsigned char *) str; *p; p++)
+  {
+    state = cm->delta[state * nc + cm->classes[*p]];
+
+    int s = (cm->output[state] != -1) ? state : cm->dict[state];
+    for (; s != -1; s = cm->dict[s])
+    {
+      int rule = cm->output[s];
+      /* If these have been seen, so have the rest of the chain */
+      if (!cm->rules[rule]->stop_matching)
+        break;
+      for (; rule != -1; rule = cm->next[rule])
+        cm->rules[rule]->stop_matching = false;
+    }
+  }
+}
+
+/**
+ * pager_colors_changed - The pager's colour patterns are about to change
+ * @param object Colour object, e.g. #MT_COLOR_BODY
+ */
+static void pager_colors_changed(int object)
+{
+  if ((object != MT_COLOR_BODY) && (object != MT_COLOR_HEADER) &&
+      (object != MT_COLOR_ATTACH_HEADERS))
+  {
+    return;
+  }
+
+  /* the pager caches the result of matching these */
+  OptPagerRecolor = true;
+  matcher_free((object == MT_COLOR_HEADER) ? &HdrMatcher : &BodyMatcher);
+}
+
 /**
  * ci_start_color - Set up the default colours
  */
@@ -688,6 +953,8 @@ static enum CommandResult parse_uncolor(struct Buffer *buf, struct Buffer *s,
     return MUTT_CMD_SUCCESS;
   }
 
+  pager_colors_changed(object);
+
   if (object == MT_COLOR_BODY)
     do_uncolor(buf, s, &ColorBodyList, &do_cache, parse_uncolor);
   else if (object == MT_COLOR_HEADER)
@@ -827,6 +1094,13 @@ static enum CommandResult add_pattern(struct ColorLineHead *top, const char *s,
         free_color_line(tmp, true);
         return MUTT_CMD_ERROR;
       }
+
+      tmp->context_free = pattern_is_context_free(s);
+
+      char literal[128];
+      const size_t len = mutt_regex_literal(s, flags, literal, sizeof(literal));
+      if (len > 0)
+        tmp->literal = mutt_str_substr_dup(literal, literal + len);
     }
     tmp->pattern = mutt_str_strdup(s);
     tmp->match = match;
@@ -1114,6 +1388,8 @@ static enum CommandResult parse_color(struct Buffer *buf, struct Buffer *s,
 #endif /* HAVE_USE_DEFAULT_COLORS */
 #endif
 
+  pager_colors_changed(object);
+
   if (object == MT_COLOR_HEADER)
     rc = add_pattern(&ColorHdrList, buf->data, false, fg, bg, attr, err, false, match);
   else if (object == MT_COLOR_BODY)
@@ -1268,6 +1544,8 @@ void mutt_free_colors(void)
   mutt_free_color_list(&ColorIndexSubjectList);
   mutt_free_color_list(&ColorIndexTagList);
   mutt_free_color_list(&ColorStatusList);
+  matcher_free(&BodyMatcher);
+  matcher_free(&HdrMatcher);
 
   struct ColorList *cl = ColorList;
   struct ColorList *next = NULL;
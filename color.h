@@ -24,12 +24,14 @@
 #define MUTT_COLOR_H
 
 struct Buffer;
+struct ColorLineHead;
 
 void ci_start_color(void);
 int  mutt_alloc_color(uint32_t fg, uint32_t bg);
 int  mutt_combine_color(uint32_t fg_attr, uint32_t bg_attr);
 void mutt_free_color(uint32_t fg, uint32_t bg);
 void mutt_free_colors(void);
+void mutt_color_prefilter(struct ColorLineHead *head, const char *str);
 enum CommandResult mutt_parse_color(struct Buffer *buf, struct Buffer *s, unsigned long data, struct Buffer *err);
 enum CommandResult mutt_parse_mono(struct Buffer *buf, struct Buffer *s, unsigned long data, struct Buffer *err);
 enum CommandResult mutt_parse_uncolor(struct Buffer *buf, struct Buffer *s, unsigned long data, struct Buffer *err);
@@ -30,11 +30,15 @@
 
 #include "config.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/types.h>
 #include <unistd.h>
 #include "mutt/mutt.h"
 #include "address/lib.h"
@@ -58,6 +62,7 @@
 #include "mutt_logging.h"
 #include "mutt_menu.h"
 #include "mutt_parse.h"
+#include "mutt_poll.h"
 #include "mutt_window.h"
 #include "muttlib.h"
 #include "mx.h"
@@ -80,6 +85,7 @@
 /* These Config Variables are only used in commands.c */
 unsigned char C_CryptVerifySig; ///< Config: Verify PGP or SMIME signatures
 char *C_DisplayFilter; ///< Config: External command to pre-process an email before display
+long C_PagerStreamSize; ///< Config: Decode messages larger than this while the pager displays them
 bool C_PipeDecode; ///< Config: Decode the message when piping it
 char *C_PipeSep;   ///< Config: Separator to add between multiple piped messages
 bool C_PipeSplit;  ///< Config: Run the pipe command on each message separately
@@ -92,6 +98,9 @@ static const char *ExtPagerProgress = "all";
 /** The folder the user last saved to.  Used by ci_save_message() */
 static char LastSaveFolder[PATH_MAX] = "";
 
+/* Most of the decoded message to copy, each time the pipe is read */
+#define STREAM_READ_MAX (1024 * 1024)
+
 /**
  * update_protected_headers - Get the protected header and update the index
  * @param cur Email to update
@@ -168,6 +177,229 @@ static void update_protected_headers(struct Email *cur)
   }
 }
 
+/**
+ * stream_wanted - Should a message be decoded while it's being displayed?
+ * @param m Mailbox
+ * @param e Email
+ * @retval true The message can be decoded by a child process
+ */
+static bool stream_wanted(struct Mailbox *m, struct Email *e)
+{
+  if ((C_PagerStreamSize <= 0) || !e->content || (e->content->length < C_PagerStreamSize))
+    return false;
+
+  /* Decryption may need a passphrase and it updates the Email */
+  if ((WithCrypto != 0) && e->security)
+    return false;
+
+  /* The mailbox's file is shared with the uncompressed copy */
+  if (m->magic == MUTT_COMPRESSED)
+    return false;
+
+  return true;
+}
+
+/**
+ * stream_finish - Flush the end of the message and reap the decoder
+ * @param ps Stream
+ */
+static void stream_finish(struct PagerStream *ps)
+{
+  if (mutt_buffer_len(ps->partial) != 0)
+  {
+    fwrite(mutt_b2s(ps->partial), 1, mutt_buffer_len(ps->partial), ps->fp);
+    mutt_buffer_reset(ps->partial);
+    ps->lines++;
+  }
+  fflush(ps->fp);
+
+  mutt_poll_remove(ps->fd);
+  close(ps->fd);
+  ps->fd = -1;
+
+  if (mutt_wait_filter(ps->pid) != 0)
+    mutt_error(_("Could not copy message"));
+  ps->pid = -1;
+  ps->changed = true;
+}
+
+/**
+ * stream_read - Copy the decoded message into the pager's file
+ * @param ps Stream
+ *
+ * Only whole lines are written, so the pager never reads half a line.
+ */
+static void stream_read(struct PagerStream *ps)
+{
+  char buf[8192];
+  size_t total = 0;
+
+  while (total < STREAM_READ_MAX)
+  {
+    ssize_t len = read(ps->fd, buf, sizeof(buf));
+    if ((len < 0) && (errno == EINTR))
+      continue;
+    if ((len < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+      break;
+    if (len <= 0)
+    {
+      stream_finish(ps);
+      return;
+    }
+    total += len;
+
+    size_t end = len;
+    while ((end > 0) && (buf[end - 1] != '\n'))
+      end--;
+
+    if (end != 0)
+    {
+      fwrite(mutt_b2s(ps->partial), 1, mutt_buffer_len(ps->partial), ps->fp);
+      mutt_buffer_reset(ps->partial);
+      fwrite(buf, 1, end, ps->fp);
+      for (size_t i = 0; i < end; i++)
+        if (buf[i] == '\n')
+          ps->lines++;
+    }
+    mutt_buffer_addstr_n(ps->partial, buf + end, len - end);
+  }
+
+  fflush(ps->fp);
+  ps->changed = true;
+}
+
+/**
+ * stream_poll_handler - Read more of the decoded message - Implements ::poll_handler_t
+ */
+static void stream_poll_handler(int fd, void *data)
+{
+  stream_read(data);
+}
+
+/**
+ * stream_start - Decode a message in the background
+ * @param fp_out  File for the decoded message
+ * @param m       Mailbox
+ * @param e       Email to display
+ * @param cmflags Flags, see #CopyMessageFlags
+ * @param chflags Flags, see #CopyHeaderFlags
+ * @retval ptr  Stream, which now owns @a fp_out
+ * @retval NULL Error, the message must be decoded in the foreground
+ *
+ * A child process runs the handlers and sends their output down a pipe.  This
+ * returns once the first screenful has arrived; the rest is copied into
+ * @a fp_out while the pager waits for keys.
+ */
+static struct PagerStream *stream_start(FILE *fp_out, struct Mailbox *m, struct Email *e,
+                                        CopyMessageFlags cmflags, CopyHeaderFlags chflags)
+{
+  /* only the parts we can display are needed */
+  OptPartialFetch = true;
+  struct Message *msg = mx_msg_open(m, e->msgno);
+  OptPartialFetch = false;
+  if (!msg)
+    return NULL;
+
+  int fds[2];
+  if (pipe(fds) == -1)
+  {
+    mx_msg_close(m, &msg);
+    return NULL;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    /* Closing the pipe, or SIGTERM, stops the decoder */
+    struct sigaction sa = { 0 };
+    sa.sa_handler = SIG_DFL;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPIPE, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    close(fds[0]);
+
+    /* Keep any messages off the screen and leave the keyboard alone */
+    int fd_null = open("/dev/null", O_RDWR);
+    if (fd_null != -1)
+    {
+      dup2(fd_null, 0);
+      dup2(fd_null, 1);
+      dup2(fd_null, 2);
+    }
+
+    /* An mbox's file position is shared with the parent, so open our own */
+    FILE *fp_in = msg->fp;
+    if ((m->magic == MUTT_MBOX) || (m->magic == MUTT_MMDF))
+      fp_in = fopen(mutt_b2s(m->pathbuf), "r");
+
+    int rc = -1;
+    FILE *fp_pipe = fdopen(fds[1], "w");
+    if (fp_in && fp_pipe)
+    {
+      OptPagerStream = true;
+      rc = mutt_copy_message_fp(fp_pipe, fp_in, e, cmflags, chflags);
+    }
+    if (!fp_pipe || (fclose(fp_pipe) != 0))
+      rc = -1;
+    _exit((rc == 0) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  mx_msg_close(m, &msg);
+  if (pid == -1)
+  {
+    close(fds[0]);
+    return NULL;
+  }
+
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+  struct PagerStream *ps = mutt_mem_calloc(1, sizeof(struct PagerStream));
+  ps->pid = pid;
+  ps->fd = fds[0];
+  ps->fp = fp_out;
+  ps->partial = mutt_buffer_new();
+
+  while ((ps->fd != -1) && (ps->lines < LINES))
+  {
+    struct pollfd pfd = { ps->fd, POLLIN, 0 };
+    if ((poll(&pfd, 1, -1) == -1) && (errno != EINTR))
+      break;
+    stream_read(ps);
+  }
+
+  if (ps->fd != -1)
+    mutt_poll_add(ps->fd, stream_poll_handler, ps);
+
+  return ps;
+}
+
+/**
+ * stream_free - Stop decoding a message and free the Stream
+ * @param ptr Stream to free
+ */
+static void stream_free(struct PagerStream **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct PagerStream *ps = *ptr;
+  if (ps->fd != -1)
+  {
+    mutt_poll_remove(ps->fd);
+    close(ps->fd);
+  }
+  if (ps->pid != -1)
+  {
+    kill(ps->pid, SIGTERM);
+    mutt_wait_filter(ps->pid);
+  }
+  mutt_file_fclose(&ps->fp);
+  mutt_buffer_free(&ps->partial);
+  FREE(ptr);
+}
+
 /**
  * mutt_display_message - Display a message in the pager
  * @param cur Header of current message
@@ -186,7 +418,10 @@ int mutt_display_message(struct Email *cur)
 
   snprintf(buf, sizeof(buf), "%s/%s", TYPE(cur->content), cur->content->subtype);
 
+  /* only the parts we can display are needed */
+  OptPartialFetch = true;
   mutt_parse_mime_message(Context->mailbox, cur);
+  OptPartialFetch = false;
   mutt_message_hook(Context->mailbox, cur, MUTT_MESSAGE_HOOK);
 
   /* see if crypto is needed for this message.  if so, we should exit curses */
@@ -270,7 +505,21 @@ int mutt_display_message(struct Email *cur)
   if (Context->mailbox->magic == MUTT_NOTMUCH)
     chflags |= CH_VIRTUAL;
 #endif
-  res = mutt_copy_message_ctx(fp_out, Context->mailbox, cur, cmflags, chflags);
+  struct PagerStream *stream = NULL;
+  if (builtin && !fp_filter_out && stream_wanted(Context->mailbox, cur))
+    stream = stream_start(fp_out, Context->mailbox, cur, cmflags, chflags);
+
+  if (stream)
+  {
+    fp_out = NULL;
+    res = 0;
+  }
+  else
+  {
+    OptPartialFetch = true;
+    res = mutt_copy_message_ctx(fp_out, Context->mailbox, cur, cmflags, chflags);
+    OptPartialFetch = false;
+  }
 
   if (((mutt_file_fclose(&fp_out) != 0) && (errno != EPIPE)) || (res < 0))
   {
@@ -334,7 +583,9 @@ int mutt_display_message(struct Email *cur)
     /* Invoke the builtin pager */
     info.email = cur;
     info.ctx = Context;
+    info.stream = stream;
     rc = mutt_pager(NULL, tempfile, MUTT_PAGER_MESSAGE, &info);
+    stream_free(&stream);
   }
   else
   {
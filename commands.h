@@ -36,6 +36,7 @@ struct Mailbox;
 /* These Config Variables are only used in commands.c */
 extern unsigned char C_CryptVerifySig; /* verify PGP signatures */
 extern char *        C_DisplayFilter;
+extern long          C_PagerStreamSize;
 extern bool          C_PipeDecode;
 extern char *        C_PipeSep;
 extern bool          C_PipeSplit;
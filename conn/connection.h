@@ -36,7 +36,7 @@ struct Connection
   struct ConnAccount account;
   unsigned int ssf; /**< security strength factor, in bits */
 
-  char inbuf[1024];
+  char inbuf[16384]; /**< Buffered data, big enough for a whole TLS record */
   int bufpos;
 
   int fd;
@@ -30,6 +30,7 @@
 
 #include "config.h"
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 #include <time.h>
 #include "mutt/mutt.h"
@@ -196,6 +197,51 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
   return -1;
 }
 
+/**
+ * socket_read - Read from a Connection, closing it on error
+ * @param conn Connection to a server
+ * @param buf  Buffer to store the data
+ * @param len  Maximum number of bytes to read
+ * @retval >0 Success, number of bytes read
+ * @retval -1 Error, the connection has been closed
+ */
+static int socket_read(struct Connection *conn, char *buf, size_t len)
+{
+  if (conn->fd < 0)
+  {
+    mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
+    return -1;
+  }
+
+  const int rc = conn->conn_read(conn, buf, len);
+  if (rc == 0)
+  {
+    mutt_error(_("Connection to %s closed"), conn->account.host);
+  }
+  if (rc <= 0)
+  {
+    mutt_socket_close(conn);
+    return -1;
+  }
+  return rc;
+}
+
+/**
+ * socket_fill - Refill the input buffer, if it's empty
+ * @param conn Connection to a server
+ * @retval  0 Success, there is data in the buffer
+ * @retval -1 Error, the connection has been closed
+ */
+static int socket_fill(struct Connection *conn)
+{
+  if (conn->bufpos < conn->available)
+    return 0;
+
+  conn->bufpos = 0;
+  conn->available = socket_read(conn, conn->inbuf, sizeof(conn->inbuf));
+  return (conn->available < 0) ? -1 : 0;
+}
+
 /**
  * mutt_socket_readchar - simple read buffering to speed things up
  * @param[in]  conn Connection to a server
@@ -205,31 +251,40 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
  */
 int mutt_socket_readchar(struct Connection *conn, char *c)
 {
-  if (conn->bufpos >= conn->available)
-  {
-    if (conn->fd >= 0)
-      conn->available = conn->conn_read(conn, conn->inbuf, sizeof(conn->inbuf));
-    else
-    {
-      mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
-      return -1;
-    }
-    conn->bufpos = 0;
-    if (conn->available == 0)
-    {
-      mutt_error(_("Connection to %s closed"), conn->account.host);
-    }
-    if (conn->available <= 0)
-    {
-      mutt_socket_close(conn);
-      return -1;
-    }
-  }
+  if (socket_fill(conn) < 0)
+    return -1;
+
   *c = conn->inbuf[conn->bufpos];
   conn->bufpos++;
   return 1;
 }
 
+/**
+ * mutt_socket_readblock - Read a block of data from a socket
+ * @param conn Connection to a server
+ * @param buf  Buffer to store the data
+ * @param len  Maximum number of bytes to read
+ * @retval >0 Success, number of bytes read
+ * @retval -1 Error
+ *
+ * Whatever is already buffered is returned first.  If the buffer is empty and
+ * the request is at least as big as the buffer, the data is read straight
+ * into the caller's buffer.
+ */
+int mutt_socket_readblock(struct Connection *conn, char *buf, size_t len)
+{
+  if ((conn->bufpos >= conn->available) && (len >= sizeof(conn->inbuf)))
+    return socket_read(conn, buf, len);
+
+  if (socket_fill(conn) < 0)
+    return -1;
+
+  len = MIN(len, conn->available - conn->bufpos);
+  memcpy(buf, conn->inbuf + conn->bufpos, len);
+  conn->bufpos += len;
+  return len;
+}
+
 /**
  * mutt_socket_readln_d - Read a line from a socket
  * @param buf    Buffer to store the line
@@ -238,23 +293,35 @@ int mutt_socket_readchar(struct Connection *conn, char *c)
  * @param dbg    Debug level for logging
  * @retval >0 Success, number of bytes read
  * @retval -1 Error
+ *
+ * The line is copied out of the Connection's buffer a chunk at a time,
+ * rather than a character at a time.
  */
 int mutt_socket_readln_d(char *buf, size_t buflen, struct Connection *conn, int dbg)
 {
-  char ch;
-  int i;
+  size_t i = 0;
+  bool eol = false;
 
-  for (i = 0; i < buflen - 1; i++)
+  while (!eol && (i < (buflen - 1)))
   {
-    if (mutt_socket_readchar(conn, &ch) != 1)
+    if (socket_fill(conn) < 0)
     {
       buf[i] = '\0';
       return -1;
     }
 
-    if (ch == '\n')
-      break;
-    buf[i] = ch;
+    const char *start = conn->inbuf + conn->bufpos;
+    size_t len = MIN(conn->available - conn->bufpos, buflen - 1 - i);
+    const char *nl = memchr(start, '\n', len);
+    if (nl)
+    {
+      len = nl - start;
+      eol = true;
+    }
+
+    memcpy(buf + i, start, len);
+    i += len;
+    conn->bufpos += len + eol;
   }
 
   /* strip \r from \r\n termination */
@@ -55,6 +55,7 @@
 #include "mutt_curses.h"
 #include "mutt_logging.h"
 #include "mutt_menu.h"
+#include "mutt_poll.h"
 #include "mutt_window.h"
 #include "muttlib.h"
 #include "opcodes.h"
@@ -65,9 +66,6 @@
 #ifdef HAVE_ISWBLANK
 #include <wctype.h>
 #endif
-#ifdef USE_INOTIFY
-#include "monitor.h"
-#endif
 
 /* These Config Variables are only used in curs_lib.c */
 bool C_MetaKey; ///< Config: Interpret 'ALT-x' as 'ESC-x'
@@ -140,13 +138,12 @@ void mutt_getch_timeout(int delay)
   timeout(delay);
 }
 
-#ifdef USE_INOTIFY
 /**
- * mutt_monitor_getch - Get a character and poll the filesystem monitor
+ * mutt_poll_getch - Get a character, while watching the other input sources
  * @retval num Character pressed
- * @retval ERR Timeout
+ * @retval ERR Timeout, or another source was handled
  */
-static int mutt_monitor_getch(void)
+static int mutt_poll_getch(void)
 {
   /* ncurses has its own internal buffer, so before we perform a poll,
    * we need to make sure there isn't a character waiting */
@@ -155,14 +152,13 @@ static int mutt_monitor_getch(void)
   timeout(MuttGetchTimeout);
   if (ch == ERR)
   {
-    if (mutt_monitor_poll() != 0)
+    if (mutt_poll_wait(MuttGetchTimeout) != 0)
       ch = ERR;
     else
       ch = getch();
   }
   return ch;
 }
-#endif /* USE_INOTIFY */
 
 /**
  * mutt_getch - Read a character from the input buffer
@@ -197,11 +193,7 @@ struct KeyEvent mutt_getch(void)
   ch = KEY_RESIZE;
   while (ch == KEY_RESIZE)
 #endif /* KEY_RESIZE */
-#ifdef USE_INOTIFY
-    ch = mutt_monitor_getch();
-#else
-  ch = getch();
-#endif /* USE_INOTIFY */
+    ch = mutt_poll_active() ? mutt_poll_getch() : getch();
   mutt_sig_allow_interrupt(0);
 
   if (SigInt)
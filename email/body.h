@@ -45,6 +45,8 @@ struct Body
                                    * attachment */
   LOFF_T offset;                  /**< offset where the actual data begins */
   LOFF_T length;                  /**< length (in bytes) of attachment */
+  LOFF_T remote_length;           /**< length on the server of a part that
+                                   * hasn't been downloaded, e.g. IMAP */
   char *filename;                 /**< when sending a message, this is the file
                                    * to which this structure refers */
   char *d_filename;               /**< filename to be used for the
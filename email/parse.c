@@ -53,6 +53,116 @@
  * Cap the value to prevent overflow of Body.length */
 #define CONTENT_TOO_BIG (1 << 30)
 
+/**
+ * enum HeaderId - Headers that mutt_rfc822_parse_line() understands
+ */
+enum HeaderId
+{
+  HEADER_UNKNOWN = 0,                ///< Header isn't recognised
+  HEADER_APPARENTLY_FROM,            ///< "Apparently-From:"
+  HEADER_APPARENTLY_TO,              ///< "Apparently-To:"
+  HEADER_BCC,                        ///< "Bcc:"
+  HEADER_CC,                         ///< "Cc:"
+  HEADER_CONTENT_DESCRIPTION,        ///< "Content-Description:"
+  HEADER_CONTENT_DISPOSITION,        ///< "Content-Disposition:"
+  HEADER_CONTENT_LANGUAGE,           ///< "Content-Language:"
+  HEADER_CONTENT_LENGTH,             ///< "Content-Length:"
+  HEADER_CONTENT_TRANSFER_ENCODING,  ///< "Content-Transfer-Encoding:"
+  HEADER_CONTENT_TYPE,               ///< "Content-Type:"
+  HEADER_DATE,                       ///< "Date:"
+  HEADER_EXPIRES,                    ///< "Expires:"
+  HEADER_FOLLOWUP_TO,                ///< "Followup-To:"
+  HEADER_FROM,                       ///< "From:"
+  HEADER_IN_REPLY_TO,                ///< "In-Reply-To:"
+  HEADER_LINES,                      ///< "Lines:"
+  HEADER_LIST_POST,                  ///< "List-Post:"
+  HEADER_MAIL_FOLLOWUP_TO,           ///< "Mail-Followup-To:"
+  HEADER_MAIL_REPLY_TO,              ///< "Mail-Reply-To:"
+  HEADER_MESSAGE_ID,                 ///< "Message-ID:"
+  HEADER_MIME_VERSION,               ///< "MIME-Version:"
+  HEADER_NEWSGROUPS,                 ///< "Newsgroups:"
+  HEADER_ORGANIZATION,               ///< "Organization:"
+  HEADER_RECEIVED,                   ///< "Received:"
+  HEADER_REFERENCES,                 ///< "References:"
+  HEADER_REPLY_TO,                   ///< "Reply-To:"
+  HEADER_RETURN_PATH,                ///< "Return-Path:"
+  HEADER_SENDER,                     ///< "Sender:"
+  HEADER_STATUS,                     ///< "Status:"
+  HEADER_SUBJECT,                    ///< "Subject:"
+  HEADER_SUPERSEDES,                 ///< "Supersedes:" (or "Supercedes:")
+  HEADER_TO,                         ///< "To:"
+  HEADER_X_COMMENT_TO,               ///< "X-Comment-To:"
+  HEADER_X_LABEL,                    ///< "X-Label:"
+  HEADER_X_ORIGINAL_TO,              ///< "X-Original-To:"
+  HEADER_X_STATUS,                   ///< "X-Status:"
+  HEADER_XREF,                       ///< "Xref:"
+};
+
+/**
+ * struct HeaderName - Name of a header that mutt_rfc822_parse_line() understands
+ */
+struct HeaderName
+{
+  const char *name; ///< Name of the header, in lower case
+  enum HeaderId id; ///< Header it identifies
+};
+
+// clang-format off
+/**
+ * HeaderNames - Names of the headers that mutt_rfc822_parse_line() understands
+ */
+static const struct HeaderName HeaderNames[] = {
+  { "apparently-from",           HEADER_APPARENTLY_FROM },
+  { "apparently-to",             HEADER_APPARENTLY_TO },
+  { "bcc",                       HEADER_BCC },
+  { "cc",                        HEADER_CC },
+  { "content-description",       HEADER_CONTENT_DESCRIPTION },
+  { "content-disposition",       HEADER_CONTENT_DISPOSITION },
+  { "content-language",          HEADER_CONTENT_LANGUAGE },
+  { "content-length",            HEADER_CONTENT_LENGTH },
+  { "content-transfer-encoding", HEADER_CONTENT_TRANSFER_ENCODING },
+  { "content-type",              HEADER_CONTENT_TYPE },
+  { "date",                      HEADER_DATE },
+  { "expires",                   HEADER_EXPIRES },
+  { "followup-to",               HEADER_FOLLOWUP_TO },
+  { "from",                      HEADER_FROM },
+  { "in-reply-to",               HEADER_IN_REPLY_TO },
+  { "lines",                     HEADER_LINES },
+  { "list-post",                 HEADER_LIST_POST },
+  { "mail-followup-to",          HEADER_MAIL_FOLLOWUP_TO },
+  { "mail-reply-to",             HEADER_MAIL_REPLY_TO },
+  { "message-id",                HEADER_MESSAGE_ID },
+  { "mime-version",              HEADER_MIME_VERSION },
+  { "newsgroups",                HEADER_NEWSGROUPS },
+  { "organization",              HEADER_ORGANIZATION },
+  { "received",                  HEADER_RECEIVED },
+  { "references",                HEADER_REFERENCES },
+  { "reply-to",                  HEADER_REPLY_TO },
+  { "return-path",               HEADER_RETURN_PATH },
+  { "sender",                    HEADER_SENDER },
+  { "status",                    HEADER_STATUS },
+  { "subject",                   HEADER_SUBJECT },
+  { "supercedes",                HEADER_SUPERSEDES },
+  { "supersedes",                HEADER_SUPERSEDES },
+  { "to",                        HEADER_TO },
+  { "x-comment-to",              HEADER_X_COMMENT_TO },
+  { "x-label",                   HEADER_X_LABEL },
+  { "x-original-to",             HEADER_X_ORIGINAL_TO },
+  { "x-status",                  HEADER_X_STATUS },
+  { "xref",                      HEADER_XREF },
+};
+// clang-format on
+
+#define HEADER_HASH_SIZE 128
+
+/**
+ * HeaderHash - Lookup table for HeaderNames
+ *
+ * Each slot holds one more than the index of the name that hashes to it, or 0.
+ * header_hash() gives every name in HeaderNames its own slot.
+ */
+static unsigned char HeaderHash[HEADER_HASH_SIZE];
+
 /**
  * mutt_auto_subscribe - Check if user is subscribed to mailing list
  * @param mailto URI of mailing list subscribe
@@ -524,6 +634,52 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
   }
 }
 
+/**
+ * header_hash - Hash the name of a header
+ * @param name Name of the header
+ * @param len  Length of the name, must be at least 1
+ * @retval num Slot in HeaderHash
+ *
+ * Letters are folded to lower case.  Other characters are left alone, which
+ * doesn't matter because a name that hashes to a slot is checked in full.
+ */
+static size_t header_hash(const char *name, size_t len)
+{
+  const unsigned char *s = (const unsigned char *) name;
+  return (len + (6 * (s[0] | 0x20)) + (5 * (s[len / 2] | 0x20)) + (3 * (s[len - 1] | 0x20))) %
+         HEADER_HASH_SIZE;
+}
+
+/**
+ * header_lookup - Identify a header by its name
+ * @param name Name of the header, e.g. "Content-Type"
+ * @retval enum #HeaderId, e.g. #HEADER_CONTENT_TYPE
+ *
+ * The name is matched ignoring case.
+ */
+static enum HeaderId header_lookup(const char *name)
+{
+  /* Fill the lookup table on first use */
+  if (HeaderHash[header_hash(HeaderNames[0].name, strlen(HeaderNames[0].name))] == 0)
+  {
+    for (size_t i = 0; i < mutt_array_size(HeaderNames); i++)
+    {
+      const char *hn = HeaderNames[i].name;
+      HeaderHash[header_hash(hn, strlen(hn))] = i + 1;
+    }
+  }
+
+  const size_t len = mutt_str_strlen(name);
+  if (len == 0)
+    return HEADER_UNKNOWN;
+
+  const int slot = HeaderHash[header_hash(name, len)];
+  if ((slot == 0) || (mutt_str_strcasecmp(name, HeaderNames[slot - 1].name) != 0))
+    return HEADER_UNKNOWN;
+
+  return HeaderNames[slot - 1].id;
+}
+
 /**
  * mutt_rfc822_parse_line - Parse an email header
  * @param env       Envelope of the email
@@ -547,374 +703,308 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e, char *line,
 
   bool matched = false;
 
-  switch (tolower(line[0]))
+  switch (header_lookup(line))
   {
-    case 'a':
-      if (mutt_str_strcasecmp(line + 1, "pparently-to") == 0)
-      {
-        mutt_addrlist_parse(&env->to, p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "pparently-from") == 0)
-      {
-        mutt_addrlist_parse(&env->from, p);
-        matched = true;
-      }
+    case HEADER_APPARENTLY_FROM:
+    case HEADER_FROM:
+      mutt_addrlist_parse(&env->from, p);
+      matched = true;
       break;
 
-    case 'b':
-      if (mutt_str_strcasecmp(line + 1, "cc") == 0)
-      {
-        mutt_addrlist_parse(&env->bcc, p);
-        matched = true;
-      }
+    case HEADER_APPARENTLY_TO:
+    case HEADER_TO:
+      mutt_addrlist_parse(&env->to, p);
+      matched = true;
+      break;
+
+    case HEADER_BCC:
+      mutt_addrlist_parse(&env->bcc, p);
+      matched = true;
+      break;
+
+    case HEADER_CC:
+      mutt_addrlist_parse(&env->cc, p);
+      matched = true;
+      break;
+
+    case HEADER_CONTENT_TYPE:
+      if (e)
+        mutt_parse_content_type(p, e->content);
+      matched = true;
       break;
 
-    case 'c':
-      if (mutt_str_strcasecmp(line + 1, "c") == 0)
+    case HEADER_CONTENT_LANGUAGE:
+      if (e)
+        parse_content_language(p, e->content);
+      matched = true;
+      break;
+
+    case HEADER_CONTENT_TRANSFER_ENCODING:
+      if (e)
+        e->content->encoding = mutt_check_encoding(p);
+      matched = true;
+      break;
+
+    case HEADER_CONTENT_LENGTH:
+      if (e)
       {
-        mutt_addrlist_parse(&env->cc, p);
-        matched = true;
+        int rc = mutt_str_atol(p, &e->content->length);
+        if ((rc < 0) || (e->content->length < 0))
+          e->content->length = -1;
+        if (e->content->length > CONTENT_TOO_BIG)
+          e->content->length = CONTENT_TOO_BIG;
       }
-      else
+      matched = true;
+      break;
+
+    case HEADER_CONTENT_DESCRIPTION:
+      if (e)
       {
-        size_t plen = mutt_str_startswith(line + 1, "ontent-", CASE_IGNORE);
-        if (plen != 0)
-        {
-          if (mutt_str_strcasecmp(line + 1 + plen, "type") == 0)
-          {
-            if (e)
-              mutt_parse_content_type(p, e->content);
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "language") == 0)
-          {
-            if (e)
-              parse_content_language(p, e->content);
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "transfer-encoding") == 0)
-          {
-            if (e)
-              e->content->encoding = mutt_check_encoding(p);
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "length") == 0)
-          {
-            if (e)
-            {
-              int rc = mutt_str_atol(p, &e->content->length);
-              if ((rc < 0) || (e->content->length < 0))
-                e->content->length = -1;
-              if (e->content->length > CONTENT_TOO_BIG)
-                e->content->length = CONTENT_TOO_BIG;
-            }
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "description") == 0)
-          {
-            if (e)
-            {
-              mutt_str_replace(&e->content->description, p);
-              rfc2047_decode(&e->content->description);
-            }
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "disposition") == 0)
-          {
-            if (e)
-              parse_content_disposition(p, e->content);
-            matched = true;
-          }
-        }
+        mutt_str_replace(&e->content->description, p);
+        rfc2047_decode(&e->content->description);
       }
+      matched = true;
+      break;
+
+    case HEADER_CONTENT_DISPOSITION:
+      if (e)
+        parse_content_disposition(p, e->content);
+      matched = true;
       break;
 
-    case 'd':
-      if (mutt_str_strcasecmp("ate", line + 1) == 0)
+    case HEADER_DATE:
+      mutt_str_replace(&env->date, p);
+      if (e)
       {
-        mutt_str_replace(&env->date, p);
-        if (e)
+        struct Tz tz;
+        e->date_sent = mutt_date_parse_date(p, &tz);
+        if (e->date_sent > 0)
         {
-          struct Tz tz;
-          e->date_sent = mutt_date_parse_date(p, &tz);
-          if (e->date_sent > 0)
-          {
-            e->zhours = tz.zhours;
-            e->zminutes = tz.zminutes;
-            e->zoccident = tz.zoccident;
-          }
+          e->zhours = tz.zhours;
+          e->zminutes = tz.zminutes;
+          e->zoccident = tz.zoccident;
         }
-        matched = true;
       }
+      matched = true;
       break;
 
-    case 'e':
-      if ((mutt_str_strcasecmp("xpires", line + 1) == 0) && e &&
-          (mutt_date_parse_date(p, NULL) < time(NULL)))
-      {
+    case HEADER_EXPIRES:
+      if (e && (mutt_date_parse_date(p, NULL) < time(NULL)))
         e->expired = true;
-      }
       break;
 
-    case 'f':
-      if (mutt_str_strcasecmp("rom", line + 1) == 0)
-      {
-        mutt_addrlist_parse(&env->from, p);
-        matched = true;
-      }
 #ifdef USE_NNTP
-      else if (mutt_str_strcasecmp(line + 1, "ollowup-to") == 0)
+    case HEADER_FOLLOWUP_TO:
+      if (!env->followup_to)
       {
-        if (!env->followup_to)
-        {
-          mutt_str_remove_trailing_ws(p);
-          env->followup_to = mutt_str_strdup(mutt_str_skip_whitespace(p));
-        }
-        matched = true;
+        mutt_str_remove_trailing_ws(p);
+        env->followup_to = mutt_str_strdup(mutt_str_skip_whitespace(p));
       }
+      matched = true;
+      break;
 #endif
+
+    case HEADER_IN_REPLY_TO:
+      mutt_list_free(&env->in_reply_to);
+      parse_references(&env->in_reply_to, p);
+      matched = true;
       break;
 
-    case 'i':
-      if (mutt_str_strcasecmp(line + 1, "n-reply-to") == 0)
+    case HEADER_LINES:
+      if (e)
       {
-        mutt_list_free(&env->in_reply_to);
-        parse_references(&env->in_reply_to, p);
-        matched = true;
+        /* HACK - neomutt has, for a very short time, produced negative
+         * Lines header values.  Ignore them.  */
+        if ((mutt_str_atoi(p, &e->lines) < 0) || (e->lines < 0))
+          e->lines = 0;
       }
+      matched = true;
       break;
 
-    case 'l':
-      if (mutt_str_strcasecmp(line + 1, "ines") == 0)
+    case HEADER_LIST_POST:
+      /* RFC2369.  FIXME: We should ignore whitespace, but don't. */
+      if (strncmp(p, "NO", 2) != 0)
       {
-        if (e)
+        char *beg = NULL, *end = NULL;
+        for (beg = strchr(p, '<'); beg; beg = strchr(end, ','))
         {
-          /* HACK - neomutt has, for a very short time, produced negative
-           * Lines header values.  Ignore them.  */
-          if ((mutt_str_atoi(p, &e->lines) < 0) || (e->lines < 0))
-            e->lines = 0;
-        }
+          beg++;
+          end = strchr(beg, '>');
+          if (!end)
+            break;
 
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "ist-Post") == 0)
-      {
-        /* RFC2369.  FIXME: We should ignore whitespace, but don't. */
-        if (strncmp(p, "NO", 2) != 0)
-        {
-          char *beg = NULL, *end = NULL;
-          for (beg = strchr(p, '<'); beg; beg = strchr(end, ','))
+          /* Take the first mailto URL */
+          if (url_check_scheme(beg) == U_MAILTO)
           {
-            beg++;
-            end = strchr(beg, '>');
-            if (!end)
-              break;
-
-            /* Take the first mailto URL */
-            if (url_check_scheme(beg) == U_MAILTO)
-            {
-              FREE(&env->list_post);
-              env->list_post = mutt_str_substr_dup(beg, end);
-              if (C_AutoSubscribe)
-                mutt_auto_subscribe(env->list_post);
+            FREE(&env->list_post);
+            env->list_post = mutt_str_substr_dup(beg, end);
+            if (C_AutoSubscribe)
+              mutt_auto_subscribe(env->list_post);
 
-              break;
-            }
+            break;
           }
         }
-        matched = true;
       }
+      matched = true;
       break;
 
-    case 'm':
-      if (mutt_str_strcasecmp(line + 1, "ime-version") == 0)
-      {
-        if (e)
-          e->mime = true;
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "essage-id") == 0)
-      {
-        /* We add a new "Message-ID:" when building a message */
-        FREE(&env->message_id);
-        env->message_id = mutt_extract_message_id(p, NULL);
-        matched = true;
-      }
-      else
-      {
-        size_t plen = mutt_str_startswith(line + 1, "ail-", CASE_IGNORE);
-        if (plen != 0)
-        {
-          if (mutt_str_strcasecmp(line + 1 + plen, "reply-to") == 0)
-          {
-            /* override the Reply-To: field */
-            mutt_addrlist_clear(&env->reply_to);
-            mutt_addrlist_parse(&env->reply_to, p);
-            matched = true;
-          }
-          else if (mutt_str_strcasecmp(line + 1 + plen, "followup-to") == 0)
-          {
-            mutt_addrlist_parse(&env->mail_followup_to, p);
-            matched = true;
-          }
-        }
-      }
+    case HEADER_MIME_VERSION:
+      if (e)
+        e->mime = true;
+      matched = true;
+      break;
+
+    case HEADER_MESSAGE_ID:
+      /* We add a new "Message-ID:" when building a message */
+      FREE(&env->message_id);
+      env->message_id = mutt_extract_message_id(p, NULL);
+      matched = true;
+      break;
+
+    case HEADER_MAIL_REPLY_TO:
+      /* override the Reply-To: field */
+      mutt_addrlist_clear(&env->reply_to);
+      mutt_addrlist_parse(&env->reply_to, p);
+      matched = true;
+      break;
+
+    case HEADER_MAIL_FOLLOWUP_TO:
+      mutt_addrlist_parse(&env->mail_followup_to, p);
+      matched = true;
       break;
 
 #ifdef USE_NNTP
-    case 'n':
-      if (mutt_str_strcasecmp(line + 1, "ewsgroups") == 0)
-      {
-        FREE(&env->newsgroups);
-        mutt_str_remove_trailing_ws(p);
-        env->newsgroups = mutt_str_strdup(mutt_str_skip_whitespace(p));
-        matched = true;
-      }
+    case HEADER_NEWSGROUPS:
+      FREE(&env->newsgroups);
+      mutt_str_remove_trailing_ws(p);
+      env->newsgroups = mutt_str_strdup(mutt_str_skip_whitespace(p));
+      matched = true;
       break;
 #endif
 
-    case 'o':
+    case HEADER_ORGANIZATION:
       /* field 'Organization:' saves only for pager! */
-      if (mutt_str_strcasecmp(line + 1, "rganization") == 0)
-      {
-        if (!env->organization && (mutt_str_strcasecmp(p, "unknown") != 0))
-          env->organization = mutt_str_strdup(p);
-      }
+      if (!env->organization && (mutt_str_strcasecmp(p, "unknown") != 0))
+        env->organization = mutt_str_strdup(p);
       break;
 
-    case 'r':
-      if (mutt_str_strcasecmp(line + 1, "eferences") == 0)
-      {
-        mutt_list_free(&env->references);
-        parse_references(&env->references, p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "eply-to") == 0)
-      {
-        mutt_addrlist_parse(&env->reply_to, p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "eturn-path") == 0)
-      {
-        mutt_addrlist_parse(&env->return_path, p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "eceived") == 0)
-      {
-        if (e && !e->received)
-        {
-          char *d = strrchr(p, ';');
+    case HEADER_REFERENCES:
+      mutt_list_free(&env->references);
+      parse_references(&env->references, p);
+      matched = true;
+      break;
 
-          if (d)
-            e->received = mutt_date_parse_date(d + 1, NULL);
-        }
-      }
+    case HEADER_REPLY_TO:
+      mutt_addrlist_parse(&env->reply_to, p);
+      matched = true;
       break;
 
-    case 's':
-      if (mutt_str_strcasecmp(line + 1, "ubject") == 0)
-      {
-        if (!env->subject)
-          env->subject = mutt_str_strdup(p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "ender") == 0)
+    case HEADER_RETURN_PATH:
+      mutt_addrlist_parse(&env->return_path, p);
+      matched = true;
+      break;
+
+    case HEADER_RECEIVED:
+      if (e && !e->received)
       {
-        mutt_addrlist_parse(&env->sender, p);
-        matched = true;
+        char *d = strrchr(p, ';');
+
+        if (d)
+          e->received = mutt_date_parse_date(d + 1, NULL);
       }
-      else if (mutt_str_strcasecmp(line + 1, "tatus") == 0)
+      break;
+
+    case HEADER_SUBJECT:
+      if (!env->subject)
+        env->subject = mutt_str_strdup(p);
+      matched = true;
+      break;
+
+    case HEADER_SENDER:
+      mutt_addrlist_parse(&env->sender, p);
+      matched = true;
+      break;
+
+    case HEADER_STATUS:
+      if (e)
       {
-        if (e)
+        while (*p)
         {
-          while (*p)
+          switch (*p)
           {
-            switch (*p)
-            {
-              case 'O':
-                e->old = C_MarkOld;
-                break;
-              case 'R':
-                e->read = true;
-                break;
-              case 'r':
-                e->replied = true;
-                break;
-            }
-            p++;
+            case 'O':
+              e->old = C_MarkOld;
+              break;
+            case 'R':
+              e->read = true;
+              break;
+            case 'r':
+              e->replied = true;
+              break;
           }
+          p++;
         }
-        matched = true;
-      }
-      else if (((mutt_str_strcasecmp("upersedes", line + 1) == 0) ||
-                (mutt_str_strcasecmp("upercedes", line + 1) == 0)) &&
-               e)
-      {
-        FREE(&env->supersedes);
-        env->supersedes = mutt_str_strdup(p);
       }
+      matched = true;
       break;
 
-    case 't':
-      if (mutt_str_strcasecmp(line + 1, "o") == 0)
+    case HEADER_SUPERSEDES:
+      if (e)
       {
-        mutt_addrlist_parse(&env->to, p);
-        matched = true;
+        FREE(&env->supersedes);
+        env->supersedes = mutt_str_strdup(p);
       }
       break;
 
-    case 'x':
-      if (mutt_str_strcasecmp(line + 1, "-status") == 0)
+    case HEADER_X_STATUS:
+      if (e)
       {
-        if (e)
+        while (*p)
         {
-          while (*p)
+          switch (*p)
           {
-            switch (*p)
-            {
-              case 'A':
-                e->replied = true;
-                break;
-              case 'D':
-                e->deleted = true;
-                break;
-              case 'F':
-                e->flagged = true;
-                break;
-              default:
-                break;
-            }
-            p++;
+            case 'A':
+              e->replied = true;
+              break;
+            case 'D':
+              e->deleted = true;
+              break;
+            case 'F':
+              e->flagged = true;
+              break;
+            default:
+              break;
           }
+          p++;
         }
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "-label") == 0)
-      {
-        FREE(&env->x_label);
-        env->x_label = mutt_str_strdup(p);
-        matched = true;
       }
+      matched = true;
+      break;
+
+    case HEADER_X_LABEL:
+      FREE(&env->x_label);
+      env->x_label = mutt_str_strdup(p);
+      matched = true;
+      break;
+
 #ifdef USE_NNTP
-      else if (mutt_str_strcasecmp(line + 1, "-comment-to") == 0)
-      {
-        if (!env->x_comment_to)
-          env->x_comment_to = mutt_str_strdup(p);
-        matched = true;
-      }
-      else if (mutt_str_strcasecmp(line + 1, "ref") == 0)
-      {
-        if (!env->xref)
-          env->xref = mutt_str_strdup(p);
-        matched = true;
-      }
+    case HEADER_X_COMMENT_TO:
+      if (!env->x_comment_to)
+        env->x_comment_to = mutt_str_strdup(p);
+      matched = true;
+      break;
+
+    case HEADER_XREF:
+      if (!env->xref)
+        env->xref = mutt_str_strdup(p);
+      matched = true;
+      break;
 #endif
-      else if (mutt_str_strcasecmp(line + 1, "-original-to") == 0)
-      {
-        mutt_addrlist_parse(&env->x_original_to, p);
-        matched = true;
-      }
+
+    case HEADER_X_ORIGINAL_TO:
+      mutt_addrlist_parse(&env->x_original_to, p);
+      matched = true;
+      break;
 
     default:
       break;
@@ -947,66 +1037,80 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e, char *line,
  * Reads an arbitrarily long header field, and looks ahead for continuation
  * lines.  "line" must point to a dynamically allocated string; it is
  * increased if more space is required to fit the whole line.
+ *
+ * The field is unfolded as it's read, one character at a time, so the buffer
+ * can be reused for every header of a message.
  */
 char *mutt_rfc822_read_line(FILE *fp, char *line, size_t *linelen)
 {
   if (!fp || !line || !linelen)
     return NULL;
 
-  char *buf = line;
-  int ch;
-  size_t offset = 0;
+  size_t len = 0;
 
-  while (true)
-  {
-    if (!fgets(buf, *linelen - offset, fp) || /* end of file or */
-        (IS_SPACE(*line) && !offset))         /* end of headers */
-    {
-      *line = '\0';
-      return line;
-    }
+  flockfile(fp);
+  int ch = getc_unlocked(fp);
 
-    const size_t len = mutt_str_strlen(buf);
-    if (len == 0)
-      return line;
+  if ((ch == EOF) || (ch == '\0') || IS_SPACE(ch))
+  {
+    /* end of file or end of headers */
+    while ((ch != EOF) && (ch != '\n'))
+      ch = getc_unlocked(fp);
+    len = 0;
+    goto done;
+  }
 
-    buf += len - 1;
-    if (*buf == '\n')
+  while (ch != EOF)
+  {
+    if (ch == '\n')
     {
-      /* we did get a full line. remove trailing space */
-      while (IS_SPACE(*buf))
-      {
-        *buf-- = '\0'; /* we can't come beyond line's beginning because
-                        * it begins with a non-space */
-      }
+      /* we did get a full line. remove trailing space.  We can't come beyond
+       * line's beginning because it begins with a non-space */
+      while (IS_SPACE(line[len - 1]))
+        len--;
 
       /* check to see if the next line is a continuation line */
-      ch = fgetc(fp);
+      ch = getc_unlocked(fp);
       if ((ch != ' ') && (ch != '\t'))
       {
         ungetc(ch, fp);
-        return line; /* next line is a separate header field or EOH */
+        goto done; /* next line is a separate header field or EOH */
       }
 
       /* eat tabs and spaces from the beginning of the continuation line */
-      while (((ch = fgetc(fp)) == ' ') || (ch == '\t'))
-        ;
-      ungetc(ch, fp);
-      *++buf = ' '; /* string is still terminated because we removed
-                       at least one whitespace char above */
+      while ((ch == ' ') || (ch == '\t'))
+        ch = getc_unlocked(fp);
+
+      /* and join the lines with a single space */
+      line[len++] = ' ';
+      continue;
     }
 
-    buf++;
-    offset = buf - line;
-    if (*linelen < (offset + 256))
+    if (ch == '\0')
+    {
+      /* ignore the rest of a line containing a NUL */
+      while ((ch != EOF) && (ch != '\n'))
+        ch = getc_unlocked(fp);
+      continue;
+    }
+
+    line[len++] = ch;
+    if ((len + 2) > *linelen)
     {
       /* grow the buffer */
-      *linelen += 256;
+      *linelen = MAX(*linelen * 2, 256);
       mutt_mem_realloc(&line, *linelen);
-      buf = line + offset;
     }
+    ch = getc_unlocked(fp);
   }
-  /* not reached */
+
+  /* end of file in the middle of a field */
+  len = 0;
+
+done:
+  funlockfile(fp);
+  line[len] = '\0';
+  return line;
 }
 
 /**
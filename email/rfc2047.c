@@ -32,7 +32,6 @@
 #include <assert.h>
 #include <errno.h>
 #include <iconv.h>
-#include <regex.h>
 #include <stdbool.h>
 #include <string.h>
 #include "mutt/mutt.h"
@@ -49,6 +48,13 @@
 
 #define CONTINUATION_BYTE(ch) (((ch) &0xc0) == 0x80)
 
+#define DECODE_MEMO_MAX 1024 ///< Forget the decoded headers after this many
+
+static struct Hash *DecodeMemo = NULL; ///< Decoded headers, keyed on the raw text
+static size_t DecodeMemoCount = 0;     ///< Number of entries in #DecodeMemo
+static char *DecodeMemoCharset = NULL; ///< $charset when #DecodeMemo was filled
+static char *DecodeMemoAssumed = NULL; ///< $assumed_charset when #DecodeMemo was filled
+
 /**
  * typedef encoder_t - Prototype for an encoding function
  * @param str    String to encode
@@ -139,39 +145,33 @@ static size_t q_encoder(char *str, const char *buf, size_t buflen, const char *t
 static char *parse_encoded_word(char *str, enum ContentEncoding *enc, char **charset,
                                 size_t *charsetlen, char **text, size_t *textlen)
 {
-  regmatch_t match[4];
-  size_t nmatch = 4;
-  struct Regex *re = mutt_regex_compile("=\\?"
-                                        "([^][()<>@,;:\\\"/?. =]+)" /* charset */
-                                        "\\?"
-                                        "([qQbB])" /* encoding */
-                                        "\\?"
-                                        "([^?]+)" /* encoded text - we accept whitespace
-                                         as some mailers do that, see #1189. */
-                                        "\\?=",
-                                        REG_EXTENDED);
-  assert(re && "Something is wrong with your RE engine.");
-
-  char *res = NULL;
-  int rc = regexec(re->regex, str, nmatch, match, 0);
-  if (rc == 0)
+  /* Match: =?charset?[qQbB]?text?=
+   * The text may contain whitespace as some mailers do that, see #1189. */
+  for (char *word = strstr(str, "=?"); word; word = strstr(word + 1, "=?"))
   {
-    /* Charset */
-    *charset = str + match[1].rm_so;
-    *charsetlen = match[1].rm_eo - match[1].rm_so;
-
-    /* Encoding: either Q or B */
-    *enc = ((str[match[2].rm_so] == 'Q') || (str[match[2].rm_so] == 'q')) ?
-               ENC_QUOTED_PRINTABLE :
-               ENC_BASE64;
-
-    *text = str + match[3].rm_so;
-    *textlen = match[3].rm_eo - match[3].rm_so;
-    res = str + match[0].rm_so;
+    char *cs = word + 2;
+    const size_t cslen = strcspn(cs, "][()<>@,;:\\\"/?. =");
+    if ((cslen == 0) || (cs[cslen] != '?'))
+      continue;
+
+    const char e = cs[cslen + 1];
+    if (((e != 'q') && (e != 'Q') && (e != 'b') && (e != 'B')) || (cs[cslen + 2] != '?'))
+      continue;
+
+    char *t = cs + cslen + 3;
+    const size_t tlen = strcspn(t, "?");
+    if ((tlen == 0) || (t[tlen] != '?') || (t[tlen + 1] != '='))
+      continue;
+
+    *charset = cs;
+    *charsetlen = cslen;
+    *enc = ((e == 'Q') || (e == 'q')) ? ENC_QUOTED_PRINTABLE : ENC_BASE64;
+    *text = t;
+    *textlen = tlen;
+    return word;
   }
 
-  mutt_regex_free(&re);
-  return res;
+  return NULL;
 }
 
 /**
@@ -214,11 +214,11 @@ static size_t try_block(const char *d, size_t dlen, const char *fromcode,
         (iconv(cd, NULL, NULL, &ob, &obl) == (size_t)(-1)))
     {
       assert(errno == E2BIG);
-      iconv_close(cd);
+      mutt_ch_iconv_close(cd);
       assert(ib > d);
       return ((ib - d) == dlen) ? dlen : ib - d + 1;
     }
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
   }
   else
   {
@@ -294,7 +294,7 @@ static size_t encode_block(char *str, char *buf, size_t buflen, const char *from
   const size_t n1 = iconv(cd, (ICONV_CONST char **) &ib, &ibl, &ob, &obl);
   const size_t n2 = iconv(cd, NULL, NULL, &ob, &obl);
   assert(n1 != (size_t)(-1) && n2 != (size_t)(-1));
-  iconv_close(cd);
+  mutt_ch_iconv_close(cd);
   return (*encoder)(str, tmp, ob - tmp, tocode);
 }
 
@@ -639,18 +639,15 @@ void rfc2047_encode(char **pd, const char *specials, int col, const char *charse
 }
 
 /**
- * rfc2047_decode - Decode any RFC2047-encoded header fields
+ * decode_string - Decode any RFC2047-encoded header fields
  * @param[in,out] pd  String to be decoded, and resulting decoded string
  *
  * Try to decode anything that looks like a valid RFC2047 encoded header field,
  * ignoring RFC822 parsing rules. If decoding fails, for example due to an
  * invalid base64 string, the original input is left untouched.
  */
-void rfc2047_decode(char **pd)
+static void decode_string(char **pd)
 {
-  if (!pd || !*pd)
-    return;
-
   struct Buffer buf = { 0 }; /* Output buffer                          */
   char *s = *pd;             /* Read pointer                           */
   char *beg = NULL;          /* Begin of encoded word                  */
@@ -740,6 +737,79 @@ void rfc2047_decode(char **pd)
   *pd = buf.data;
 }
 
+/**
+ * memo_free - Free a decoded header - Implements ::hashelem_free_t
+ */
+static void memo_free(int type, void *obj, intptr_t data)
+{
+  FREE(&obj);
+}
+
+/**
+ * rfc2047_decode_cleanup - Forget the decoded headers
+ *
+ * Headers repeat a lot within a mailbox, e.g. list names and senders, so
+ * rfc2047_decode() remembers the results.  This should be called when the
+ * mailbox is closed, or the charset hooks change.
+ */
+void rfc2047_decode_cleanup(void)
+{
+  mutt_hash_free(&DecodeMemo);
+  DecodeMemoCount = 0;
+  FREE(&DecodeMemoCharset);
+  FREE(&DecodeMemoAssumed);
+}
+
+/**
+ * rfc2047_decode - Decode any RFC2047-encoded header fields
+ * @param[in,out] pd  String to be decoded, and resulting decoded string
+ *
+ * Try to decode anything that looks like a valid RFC2047 encoded header field,
+ * ignoring RFC822 parsing rules. If decoding fails, for example due to an
+ * invalid base64 string, the original input is left untouched.
+ */
+void rfc2047_decode(char **pd)
+{
+  if (!pd || !*pd)
+    return;
+
+  /* Nothing to decode, and nothing to convert */
+  if (!strstr(*pd, "=?") && (!C_AssumedCharset || mutt_str_is_ascii(*pd, strlen(*pd))))
+    return;
+
+  if ((mutt_str_strcmp(DecodeMemoCharset, C_Charset) != 0) ||
+      (mutt_str_strcmp(DecodeMemoAssumed, C_AssumedCharset) != 0) ||
+      (DecodeMemoCount >= DECODE_MEMO_MAX))
+  {
+    rfc2047_decode_cleanup();
+  }
+
+  if (!DecodeMemo)
+  {
+    DecodeMemo = mutt_hash_new(DECODE_MEMO_MAX, MUTT_HASH_STRDUP_KEYS);
+    mutt_hash_set_destructor(DecodeMemo, memo_free, 0);
+    DecodeMemoCharset = mutt_str_strdup(C_Charset);
+    DecodeMemoAssumed = mutt_str_strdup(C_AssumedCharset);
+  }
+
+  const char *decoded = mutt_hash_find(DecodeMemo, *pd);
+  if (decoded)
+  {
+    mutt_str_replace(pd, decoded);
+    return;
+  }
+
+  char *raw = mutt_str_strdup(*pd);
+  char *orig = *pd;
+  decode_string(pd);
+  if (*pd != orig)
+  {
+    mutt_hash_insert(DecodeMemo, raw, mutt_str_strdup(*pd));
+    DecodeMemoCount++;
+  }
+  FREE(&raw);
+}
+
 /**
  * rfc2047_encode_addrlist - Encode any RFC2047 headers, where required, in an Address list
  * @param al   AddressList
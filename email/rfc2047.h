@@ -29,6 +29,7 @@ struct AddressList;
 struct Envelope;
 
 void rfc2047_decode(char **pd);
+void rfc2047_decode_cleanup(void);
 void rfc2047_encode(char **pd, const char *specials, int col, const char *charsets);
 
 void rfc2047_decode_addrlist(struct AddressList *al);
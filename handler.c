@@ -71,6 +71,8 @@ char *C_ShowMultipartAlternative; ///< Config: How to display 'multipart/alterna
 
 #define BUFI_SIZE 1000
 #define BUFO_SIZE 2000
+#define BUFE_SIZE 16384 ///< Size of a block of encoded input
+#define TEXT_SLICE_SIZE (64 * 1024) ///< Size of a slice of a large text part
 
 #define TXT_HTML 1
 #define TXT_PLAIN 2
@@ -248,6 +250,17 @@ static void qp_decode_line(char *dest, char *src, size_t *l, int last)
 
   for (d = dest, s = src; *s;)
   {
+    /* copy everything up to the next '=' in one go */
+    const size_t run = strcspn(s, "=");
+    if (run != 0)
+    {
+      memcpy(d, s, run);
+      d += run;
+      s += run;
+      kind = -1;
+      continue;
+    }
+
     switch ((kind = qp_decode_triple(s, &c)))
     {
       case 0:
@@ -1416,6 +1429,104 @@ static int run_decode_and_handler(struct Body *b, struct State *s,
   return rc;
 }
 
+/**
+ * text_slice_end - Find a place to split a text part
+ * @param fp       File to read from
+ * @param start    Earliest end of the slice
+ * @param end      End of the part
+ * @param encoding Transfer encoding, e.g. #ENC_QUOTED_PRINTABLE
+ * @retval num Offset just after a line break that decodes to a newline
+ */
+static LOFF_T text_slice_end(FILE *fp, LOFF_T start, LOFF_T end, int encoding)
+{
+  if ((start >= end) || (fseeko(fp, start, SEEK_SET) != 0))
+    return end;
+
+  /* The start may be in the middle of a quoted-printable soft line break,
+   * so only a complete line can be checked */
+  bool whole = false;
+  int last = 0;
+  int c;
+  for (LOFF_T pos = start; (pos < end) && ((c = fgetc(fp)) != EOF);)
+  {
+    pos++;
+    if (c == '\n')
+    {
+      if ((encoding != ENC_QUOTED_PRINTABLE) || (whole && (last != '=')))
+        return pos;
+      whole = true;
+      last = 0;
+    }
+    else if (!isspace(c))
+      last = c;
+  }
+
+  return end;
+}
+
+/**
+ * text_slice_charset - Can a text part be split at any newline?
+ * @param b Body of the email
+ * @retval true The charset is ASCII-compatible and stateless
+ *
+ * Each slice is converted from the start, so a slice mustn't begin in the
+ * middle of a character, or depend on a shift state set by an earlier one.
+ */
+static bool text_slice_charset(struct Body *b)
+{
+  static const char *const safe[] = {
+    "us-ascii", "utf-8", "iso-8859-", "windows-", "koi8-",     "euc-",
+    "gb2312",   "gbk",   "gb18030",   "big5",     "shift_jis",
+  };
+
+  const char *charset = mutt_param_get(&b->parameter, "charset");
+  if (!charset && C_AssumedCharset)
+    charset = mutt_ch_get_default_charset();
+  if (!charset)
+    return true;
+
+  char canon[256];
+  mutt_ch_canonical_charset(canon, sizeof(canon), charset);
+  for (size_t i = 0; i < mutt_array_size(safe); i++)
+  {
+    if (mutt_str_startswith(canon, safe[i], CASE_IGNORE))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * run_decode_in_slices - Decode and handle a large text part a slice at a time
+ * @param b       Body of the email
+ * @param s       State of text being processed
+ * @param handler Line-oriented handler
+ * @retval 0 Success
+ * @retval -1 Error
+ *
+ * The handler sees runs of whole lines, so its output is unchanged, but the
+ * start of the text is written without waiting for the rest to be decoded.
+ */
+static int run_decode_in_slices(struct Body *b, struct State *s, handler_t handler)
+{
+  const LOFF_T offset = b->offset;
+  const LOFF_T length = b->length;
+  const LOFF_T end = offset + length;
+  int rc = 0;
+
+  for (LOFF_T pos = offset; (pos < end) && (rc == 0);)
+  {
+    LOFF_T next = text_slice_end(s->fp_in, pos + TEXT_SLICE_SIZE, end, b->encoding);
+    b->offset = pos;
+    b->length = next - pos;
+    rc = run_decode_and_handler(b, s, handler, false);
+    pos = next;
+  }
+
+  b->offset = offset;
+  b->length = length;
+  return rc;
+}
+
 /**
  * valid_pgp_encrypted_handler - Handler for valid pgp-encrypted emails - Implements ::handler_t
  */
@@ -1479,55 +1590,29 @@ static int malformed_pgp_encrypted_handler(struct Body *b, struct State *s)
  */
 void mutt_decode_base64(struct State *s, size_t len, bool istext, iconv_t cd)
 {
-  char buf[5];
-  int ch, i;
-  char bufi[BUFI_SIZE];
+  char bufe[BUFE_SIZE];
+  char bufi[BUFI_SIZE + ((BUFE_SIZE + 3) / 4) * 3];
   size_t l = 0;
-
-  buf[4] = '\0';
+  struct B64Decoder dec = { 0 };
 
   if (istext)
     state_set_prefix(s);
 
-  while (len > 0)
+  while ((len > 0) && !dec.done)
   {
-    for (i = 0; (i < 4) && (len > 0); len--)
-    {
-      ch = fgetc(s->fp_in);
-      if (ch == EOF)
-        break;
-      if ((ch >= 0) && (ch < 128) && ((base64val(ch) != -1) || (ch == '=')))
-        buf[i++] = ch;
-    }
-    if (i != 4)
-    {
-      /* "i" may be zero if there is trailing whitespace, which is not an error */
-      if (i != 0)
-        mutt_debug(LL_DEBUG2, "didn't get a multiple of 4 chars\n");
-      break;
-    }
-
-    const int c1 = base64val(buf[0]);
-    const int c2 = base64val(buf[1]);
-    ch = (c1 << 2) | (c2 >> 4);
-    bufi[l++] = ch;
-
-    if (buf[2] == '=')
+    size_t n = fread(bufe, 1, MIN(len, sizeof(bufe)), s->fp_in);
+    if (n == 0)
       break;
-    const int c3 = base64val(buf[2]);
-    ch = ((c2 & 0xf) << 4) | (c3 >> 2);
-    bufi[l++] = ch;
+    len -= n;
 
-    if (buf[3] == '=')
-      break;
-    const int c4 = base64val(buf[3]);
-    ch = ((c3 & 0x3) << 6) | c4;
-    bufi[l++] = ch;
-
-    if ((l + 8) >= sizeof(bufi))
-      convert_to_state(cd, bufi, &l, s);
+    l += mutt_b64_decode_stream(&dec, bufe, n, bufi + l);
+    convert_to_state(cd, bufi, &l, s);
   }
 
+  /* "num" may be zero if there is trailing whitespace, which is not an error */
+  if (dec.num != 0)
+    mutt_debug(LL_DEBUG2, "didn't get a multiple of 4 chars\n");
+
   convert_to_state(cd, bufi, &l, s);
   convert_to_state(cd, 0, 0, s);
 
@@ -1668,7 +1753,16 @@ int mutt_body_handler(struct Body *b, struct State *s)
       goto cleanup;
     }
 
-    rc = run_decode_and_handler(b, s, handler, plaintext);
+    /* Only the pager's stream gains from seeing the start of the text early */
+    if (OptPagerStream && (handler == text_plain_handler) && (b->length > TEXT_SLICE_SIZE) &&
+        ((b->encoding == ENC_7BIT) || (b->encoding == ENC_8BIT) ||
+         (b->encoding == ENC_BINARY) || (b->encoding == ENC_QUOTED_PRINTABLE)) &&
+        text_slice_charset(b))
+    {
+      rc = run_decode_in_slices(b, s, handler);
+    }
+    else
+      rc = run_decode_and_handler(b, s, handler, plaintext);
   }
   /* print hint to use attachment menu for disposition == attachment
    * if we're not already being called from there */
@@ -1832,5 +1926,5 @@ void mutt_decode_attachment(struct Body *b, struct State *s)
   }
 
   if (cd != (iconv_t)(-1))
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
 }
@@ -244,6 +244,7 @@ enum CommandResult mutt_parse_hook(struct Buffer *buf, struct Buffer *s,
     enum LookupType type = (data & MUTT_CHARSET_HOOK) ? MUTT_LOOKUP_CHARSET : MUTT_LOOKUP_ICONV;
     if (!mutt_ch_lookup_add(type, pattern.data, cmd.data, err))
       goto error;
+    rfc2047_decode_cleanup();
     FREE(&pattern.data);
     FREE(&cmd.data);
     return MUTT_CMD_SUCCESS;
@@ -477,6 +478,7 @@ enum CommandResult mutt_parse_unhook(struct Buffer *buf, struct Buffer *s,
       mutt_delete_hooks(MUTT_HOOK_NO_FLAGS);
       delete_idxfmt_hooks();
       mutt_ch_lookup_remove();
+      rfc2047_decode_cleanup();
     }
     else
     {
@@ -490,6 +492,7 @@ enum CommandResult mutt_parse_unhook(struct Buffer *buf, struct Buffer *s,
       if (type & (MUTT_CHARSET_HOOK | MUTT_ICONV_HOOK))
       {
         mutt_ch_lookup_remove();
+        rfc2047_decode_cleanup();
         return MUTT_CMD_SUCCESS;
       }
       if (current_hook_type == type)
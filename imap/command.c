@@ -49,6 +49,7 @@
 #include "mutt_account.h"
 #include "mutt_logging.h"
 #include "mutt_menu.h"
+#include "mutt_poll.h"
 #include "mutt_socket.h"
 #include "mx.h"
 
@@ -69,6 +70,8 @@ static const char *const Capabilities[] = {
   "STARTTLS",    "LOGINDISABLED",  "IDLE",
   "SASL-IR",     "ENABLE",         "CONDSTORE",
   "QRESYNC",     "LIST-EXTENDED",  "X-GM-EXT-1",
+  "SORT",        "ESEARCH",        "BINARY",
+  "NOTIFY",
   NULL,
 };
 
@@ -85,6 +88,22 @@ static bool cmd_queue_full(struct ImapAccountData *adata)
   return false;
 }
 
+/**
+ * cmd_pending - Are any commands waiting for a reply?
+ * @param adata Imap Account data
+ * @retval true A command hasn't completed yet
+ */
+static bool cmd_pending(struct ImapAccountData *adata)
+{
+  for (int c = adata->lastcmd; c != adata->nextcmd; c = (c + 1) % adata->cmdslots)
+  {
+    if (adata->cmds[c].state == IMAP_CMD_NEW)
+      return true;
+  }
+
+  return false;
+}
+
 /**
  * cmd_new - Create and queue a new command control block
  * @param adata Imap Account data
@@ -161,6 +180,7 @@ static void cmd_handle_fatal(struct ImapAccountData *adata)
   if ((adata->state >= IMAP_SELECTED) && (mdata->reopen & IMAP_REOPEN_ALLOW))
   {
     mx_fastclose_mailbox(adata->mailbox);
+    mutt_poll_remove(adata->conn->fd);
     mutt_socket_close(adata->conn);
     mutt_error(_("Mailbox %s@%s closed"), adata->conn->account.user,
                adata->conn->account.host);
@@ -201,8 +221,9 @@ static int cmd_start(struct ImapAccountData *adata, const char *cmdstr, ImapCmdF
   if (flags & IMAP_CMD_QUEUE)
     return 0;
 
+  /* nothing to send, but there may still be replies to wait for */
   if (mutt_buffer_len(adata->cmdbuf) == 0)
-    return IMAP_CMD_BAD;
+    return cmd_pending(adata) ? 0 : IMAP_CMD_BAD;
 
   rc = mutt_socket_send_d(adata->conn, adata->cmdbuf->data,
                           (flags & IMAP_CMD_PASS) ? IMAP_LOG_PASS : IMAP_LOG_CMD);
@@ -210,7 +231,10 @@ static int cmd_start(struct ImapAccountData *adata, const char *cmdstr, ImapCmdF
 
   /* unidle when command queue is flushed */
   if (adata->state == IMAP_IDLE)
+  {
     adata->state = IMAP_SELECTED;
+    mutt_poll_remove(adata->conn->fd);
+  }
 
   return (rc < 0) ? IMAP_CMD_BAD : 0;
 }
@@ -275,6 +299,9 @@ static void cmd_parse_expunge(struct ImapAccountData *adata, const char *s)
   mdata->msn_index[mdata->max_msn - 1] = NULL;
   mdata->max_msn--;
 
+  if (exp_msn <= mdata->backfill_msn)
+    mdata->backfill_msn--;
+
   mdata->reopen |= IMAP_EXPUNGE_PENDING;
 }
 
@@ -781,6 +808,103 @@ static void cmd_parse_search(struct ImapAccountData *adata, const char *s)
   }
 }
 
+/**
+ * cmd_parse_esearch - store ESEARCH response for later use
+ * @param adata Imap Account data
+ * @param s     Command string with search results
+ *
+ * Handle ESEARCH (RFC4731), which returns the matching UIDs as a seqset, e.g.
+ * `* ESEARCH (TAG "a0001") UID ALL 3:5,9`
+ */
+static void cmd_parse_esearch(struct ImapAccountData *adata, char *s)
+{
+  int rc;
+  unsigned int uid = 0;
+  struct Email *e = NULL;
+  struct ImapMboxData *mdata = adata->mailbox->mdata;
+
+  mutt_debug(LL_DEBUG2, "Handling ESEARCH\n");
+
+  s = imap_next_word(s);
+
+  /* skip the search correlator */
+  if (*s == '(')
+  {
+    s = strchr(s, ')');
+    if (!s)
+      return;
+    s = imap_next_word(s);
+  }
+
+  if (mutt_str_startswith(s, "UID", CASE_IGNORE))
+    s = imap_next_word(s);
+
+  /* no ALL means no matches */
+  if (!mutt_str_startswith(s, "ALL", CASE_IGNORE))
+    return;
+  s = imap_next_word(s);
+
+  char *end_of_seqset = s;
+  while (*end_of_seqset && strchr("0123456789:,", *end_of_seqset))
+    end_of_seqset++;
+  *end_of_seqset = '\0';
+
+  struct SeqsetIterator *iter = mutt_seqset_iterator_new(s);
+  if (!iter)
+  {
+    mutt_debug(LL_DEBUG2, "ESEARCH: empty seqset [%s]?\n", s);
+    return;
+  }
+
+  while ((rc = mutt_seqset_iterator_next(iter, &uid)) == 0)
+  {
+    e = mutt_hash_int_find(mdata->uid_hash, uid);
+    if (e)
+      e->matched = true;
+  }
+
+  if (rc < 0)
+    mutt_debug(LL_DEBUG1, "ESEARCH: illegal seqset %s\n", s);
+
+  mutt_seqset_iterator_free(&iter);
+}
+
+/**
+ * cmd_parse_sort - store SORT response for later use
+ * @param adata Imap Account data
+ * @param s     Command string with sort results
+ *
+ * The UIDs are given in the order chosen by the server.
+ * The matching Emails are collected in ImapMboxData.sort_result.
+ */
+static void cmd_parse_sort(struct ImapAccountData *adata, const char *s)
+{
+  unsigned int uid;
+  struct Email *e = NULL;
+  struct ImapMboxData *mdata = adata->mailbox->mdata;
+
+  mutt_debug(LL_DEBUG2, "Handling SORT\n");
+
+  if (!mdata->sort_result)
+    return;
+
+  while ((s = imap_next_word((char *) s)) && (*s != '\0'))
+  {
+    if (mutt_str_atoui(s, &uid) < 0)
+      continue;
+    e = mutt_hash_int_find(mdata->uid_hash, uid);
+    if (!e)
+      continue;
+    if ((mdata->sort_count < 0) || (mdata->sort_count >= mdata->sort_max))
+    {
+      mutt_debug(LL_DEBUG1, "Unexpected SORT result\n");
+      mdata->sort_count = -1;
+      return;
+    }
+    mdata->sort_result[mdata->sort_count++] = e;
+  }
+}
+
 /**
  * cmd_parse_status - Parse status from server
  * @param adata Imap Account data
@@ -839,9 +963,17 @@ static void cmd_parse_status(struct ImapAccountData *adata, char *s)
     mutt_debug(LL_DEBUG3, "Received status for an unexpected mailbox: %s\n", mailbox);
     return;
   }
+
   olduv = mdata->uid_validity;
   oldun = mdata->uid_next;
 
+  unsigned int messages = mdata->messages;
+  unsigned int recent = mdata->recent;
+  unsigned int uid_next = mdata->uid_next;
+  unsigned int uid_validity = mdata->uid_validity;
+  unsigned int unseen = mdata->unseen;
+  bool have_unseen = false;
+
   if (*s++ != '(')
   {
     mutt_debug(LL_DEBUG1, "Error parsing STATUS\n");
@@ -861,20 +993,39 @@ static void cmd_parse_status(struct ImapAccountData *adata, char *s)
     const unsigned int count = (unsigned int) ulcount;
 
     if (mutt_str_startswith(s, "MESSAGES", CASE_MATCH))
-      mdata->messages = count;
+      messages = count;
     else if (mutt_str_startswith(s, "RECENT", CASE_MATCH))
-      mdata->recent = count;
+      recent = count;
     else if (mutt_str_startswith(s, "UIDNEXT", CASE_MATCH))
-      mdata->uid_next = count;
+      uid_next = count;
     else if (mutt_str_startswith(s, "UIDVALIDITY", CASE_MATCH))
-      mdata->uid_validity = count;
+      uid_validity = count;
     else if (mutt_str_startswith(s, "UNSEEN", CASE_MATCH))
-      mdata->unseen = count;
+    {
+      unseen = count;
+      have_unseen = true;
+    }
 
     s = value;
     if (*s && (*s != ')'))
       s = imap_next_word(s);
   }
+
+  /* A NOTIFY event only says that the mailbox has changed.  Rather than
+   * update half the counts, ask for a full STATUS at the next mail check. */
+  if (adata->notify && !have_unseen)
+  {
+    mutt_debug(LL_DEBUG3, "NOTIFY: %s has changed\n", mailbox);
+    mdata->notify_stale = true;
+    return;
+  }
+  mdata->notify_stale = false;
+
+  mdata->messages = messages;
+  mdata->recent = recent;
+  mdata->uid_next = uid_next;
+  mdata->uid_validity = uid_validity;
+  mdata->unseen = unseen;
   mutt_debug(LL_DEBUG3, "%s (UIDVALIDITY: %u, UIDNEXT: %u) %d messages, %d recent, %d unseen\n",
              mdata->name, mdata->uid_validity, mdata->uid_next, mdata->messages,
              mdata->recent, mdata->unseen);
@@ -1015,6 +1166,10 @@ static int cmd_handle_untagged(struct ImapAccountData *adata)
     cmd_parse_myrights(adata, s);
   else if (mutt_str_startswith(s, "SEARCH", CASE_IGNORE))
     cmd_parse_search(adata, s);
+  else if ((adata->state >= IMAP_SELECTED) && mutt_str_startswith(s, "ESEARCH", CASE_IGNORE))
+    cmd_parse_esearch(adata, s);
+  else if ((adata->state >= IMAP_SELECTED) && mutt_str_startswith(s, "SORT", CASE_IGNORE))
+    cmd_parse_sort(adata, s);
   else if (mutt_str_startswith(s, "STATUS", CASE_IGNORE))
     cmd_parse_status(adata, s);
   else if (mutt_str_startswith(s, "ENABLED", CASE_IGNORE))
@@ -1282,6 +1437,26 @@ int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags fl
   return IMAP_EXEC_SUCCESS;
 }
 
+/**
+ * imap_cmd_flush - Send the queued commands, without waiting for the replies
+ * @param adata Imap Account data
+ * @retval  1 Success, replies are pending
+ * @retval  0 Success, there's nothing to wait for
+ * @retval -1 Failure
+ *
+ * The replies can be collected later by calling imap_exec() with no command.
+ */
+int imap_cmd_flush(struct ImapAccountData *adata)
+{
+  if ((mutt_buffer_len(adata->cmdbuf) != 0) && (cmd_start(adata, NULL, IMAP_CMD_NO_FLAGS) < 0))
+  {
+    cmd_handle_fatal(adata);
+    return -1;
+  }
+
+  return cmd_pending(adata) ? 1 : 0;
+}
+
 /**
  * imap_cmd_finish - Attempt to perform cleanup
  * @param adata Imap Account data
@@ -1345,6 +1520,33 @@ void imap_cmd_finish(struct ImapAccountData *adata)
   adata->status = 0;
 }
 
+/**
+ * idle_poll_handler - Read the responses to IDLE - Implements ::poll_handler_t
+ *
+ * The responses are read while NeoMutt waits for a key, so new mail is noticed
+ * at once, rather than after $timeout.
+ */
+static void idle_poll_handler(int fd, void *data)
+{
+  struct ImapAccountData *adata = data;
+
+  if ((adata->state != IMAP_IDLE) || !adata->conn || (adata->conn->fd != fd))
+  {
+    mutt_poll_remove(fd);
+    return;
+  }
+
+  while (mutt_socket_poll(adata->conn, 0) > 0)
+  {
+    if (imap_cmd_step(adata) != IMAP_CMD_CONTINUE)
+    {
+      mutt_debug(LL_DEBUG1, "Error reading IDLE response\n");
+      mutt_poll_remove(fd);
+      break;
+    }
+  }
+}
+
 /**
  * imap_cmd_idle - Enter the IDLE state
  * @param adata Imap Account data
@@ -1376,6 +1578,7 @@ int imap_cmd_idle(struct ImapAccountData *adata)
   {
     /* successfully entered IDLE state */
     adata->state = IMAP_IDLE;
+    mutt_poll_add(adata->conn->fd, idle_poll_handler, adata);
     /* queue automatic exit when next command is issued */
     mutt_buffer_addstr(adata->cmdbuf, "DONE\r\n");
     rc = IMAP_CMD_OK;
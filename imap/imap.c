@@ -54,6 +54,7 @@
 #include "message.h"
 #include "mutt_account.h"
 #include "mutt_logging.h"
+#include "mutt_poll.h"
 #include "mutt_socket.h"
 #include "muttlib.h"
 #include "mx.h"
@@ -68,7 +69,9 @@ struct stat;
 
 /* These Config Variables are only used in imap/imap.c */
 bool C_ImapIdle; ///< Config: (imap) Use the IMAP IDLE extension to check for new mail
+bool C_ImapNotify; ///< Config: (imap) Use the IMAP NOTIFY extension to check other mailboxes
 bool C_ImapRfc5161; ///< Config: (imap) Use the IMAP ENABLE extension to select capabilities
+bool C_ImapServerSort; ///< Config: (imap) Let the server sort the mailbox (RFC5256)
 
 /**
  * check_capabilities - Make sure we can log in to this server
@@ -332,41 +335,157 @@ static int sync_helper(struct Mailbox *m, AclFlags right, int flag, const char *
 }
 
 /**
- * do_search - Perform a search of messages
- * @param search  List of pattern to match
- * @param allpats Must all patterns match?
- * @retval num Number of patterns search that should be done server-side
+ * search_needs_server - Does a Pattern need the text of the messages?
+ * @param pat Pattern to check
+ * @retval true The Pattern, or one of its children, needs the server
  *
- * Count the number of patterns that can be done by the server (are full-text).
+ * Body and header searches would require NeoMutt to download every message.
+ * Server-side custom searches can only be done by the server.
  */
-static int do_search(const struct PatternHead *search, bool allpats)
+static bool search_needs_server(const struct Pattern *pat)
 {
-  int rc = 0;
-  const struct Pattern *pat = NULL;
+  switch (pat->op)
+  {
+    case MUTT_PAT_BODY:
+    case MUTT_PAT_HEADER:
+    case MUTT_PAT_WHOLE_MSG:
+    case MUTT_PAT_SERVERSEARCH:
+      return true;
+    default:
+      if (pat->child)
+      {
+        const struct Pattern *np = NULL;
+        SLIST_FOREACH(np, pat->child, entries)
+        {
+          if (search_needs_server(np))
+            return true;
+        }
+      }
+      return false;
+  }
+}
 
-  SLIST_FOREACH(pat, search, entries)
+/**
+ * search_is_expressible - Can the server evaluate a Pattern?
+ * @param pat Pattern to check
+ * @retval true The Pattern, and all its children, can be sent to the server
+ *
+ * IMAP SEARCH only offers case-insensitive substring matches.  Terms that
+ * NeoMutt can already evaluate locally are only sent to the server if the
+ * answer would be the same, i.e. they're ignoring case.
+ */
+static bool search_is_expressible(const struct Pattern *pat)
+{
+  switch (pat->op)
   {
-    switch (pat->op)
+    case MUTT_PAT_AND:
+    case MUTT_PAT_OR:
     {
-      case MUTT_PAT_BODY:
-      case MUTT_PAT_HEADER:
-      case MUTT_PAT_WHOLE_MSG:
-        if (pat->stringmatch)
-          rc++;
-        break;
-      case MUTT_PAT_SERVERSEARCH:
-        rc++;
-        break;
-      default:
-        if (pat->child && do_search(pat->child, true))
-          rc++;
+      const struct Pattern *np = NULL;
+      SLIST_FOREACH(np, pat->child, entries)
+      {
+        if (!search_is_expressible(np))
+          return false;
+      }
+      return true;
     }
+    case MUTT_PAT_BODY:
+    case MUTT_PAT_WHOLE_MSG:
+    case MUTT_PAT_SERVERSEARCH:
+      return pat->stringmatch;
+    case MUTT_PAT_HEADER:
+    {
+      if (!pat->stringmatch)
+        return false;
+      /* the header name must be a single word */
+      const char *delim = strchr(pat->p.str, ':');
+      if (!delim || (delim == pat->p.str))
+        return false;
+      for (const char *c = pat->p.str; c < delim; c++)
+        if (IS_SPACE(*c))
+          return false;
+      return true;
+    }
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+      return pat->stringmatch && pat->ign_case && !pat->alladdr && !pat->isalias;
+    default:
+      return false;
+  }
+}
 
-    if (!allpats)
-      break;
+/**
+ * search_clear - Forget which Patterns the server will evaluate
+ * @param pat Pattern to clear
+ */
+static void search_clear(struct Pattern *pat)
+{
+  pat->isserver = false;
+  if (!pat->child)
+    return;
+
+  struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat->child, entries)
+  {
+    search_clear(np);
   }
+}
 
-  return rc;
+/**
+ * search_select_and - Select server Patterns that are ANDed together
+ * @param pat Pattern to check
+ * @retval num Number of Patterns selected
+ *
+ * The results of every selected Pattern are stored in the same bit,
+ * Email.matched, so they are sent to the server as a single search.
+ * That's only correct if the Patterns must all match, i.e. they are only
+ * joined to the top of the tree by (non-negated) AND operations.
+ */
+static int search_select_and(struct Pattern *pat)
+{
+  if (search_needs_server(pat) && search_is_expressible(pat))
+  {
+    pat->isserver = true;
+    return 1;
+  }
+
+  if ((pat->op != MUTT_PAT_AND) || pat->not)
+    return 0;
+
+  int count = 0;
+  struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat->child, entries)
+  {
+    count += search_select_and(np);
+  }
+  return count;
+}
+
+/**
+ * search_select_any - Select the first Pattern that the server can evaluate
+ * @param pat Pattern to check
+ * @retval true A Pattern was selected
+ */
+static bool search_select_any(struct Pattern *pat)
+{
+  if (search_needs_server(pat) && search_is_expressible(pat))
+  {
+    pat->isserver = true;
+    return true;
+  }
+
+  if (!pat->child)
+    return false;
+
+  struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat->child, entries)
+  {
+    if (search_select_any(np))
+      return true;
+  }
+  return false;
 }
 
 /**
@@ -377,109 +496,135 @@ static int do_search(const struct PatternHead *search, bool allpats)
  * @retval  0 Success
  * @retval -1 Failure
  *
- * Convert neomutt Pattern to IMAP SEARCH command containing only elements
- * that require full-text search (neomutt already has what it needs for most
- * match types, and does a better job (eg server doesn't support regexes).
+ * Convert a Pattern, which must satisfy search_is_expressible(), to the
+ * criteria of an IMAP SEARCH command.
  */
-static int compile_search(struct Mailbox *m, const struct PatternHead *pat, struct Buffer *buf)
+static int compile_search(struct Mailbox *m, const struct Pattern *pat, struct Buffer *buf)
 {
-  struct Pattern *firstpat = SLIST_FIRST(pat);
-
-  if (do_search(pat, false) == 0)
-    return 0;
+  char term[256];
 
-  if (firstpat->not)
+  if (pat->not)
     mutt_buffer_addstr(buf, "NOT ");
 
-  if (firstpat->child)
+  switch (pat->op)
   {
-    int clauses;
-
-    clauses = do_search(firstpat->child, true);
-    if (clauses > 0)
+    case MUTT_PAT_AND:
+    case MUTT_PAT_OR:
     {
+      const struct Pattern *np = NULL;
       mutt_buffer_addch(buf, '(');
-
-      while (clauses)
+      SLIST_FOREACH(np, pat->child, entries)
       {
-        if (do_search(firstpat->child, false))
-        {
-          if ((firstpat->op == MUTT_PAT_OR) && (clauses > 1))
-            mutt_buffer_addstr(buf, "OR ");
-          clauses--;
-
-          if (compile_search(m, firstpat->child, buf) < 0)
-            return -1;
+        if ((pat->op == MUTT_PAT_OR) && SLIST_NEXT(np, entries))
+          mutt_buffer_addstr(buf, "OR ");
 
-          if (clauses)
-            mutt_buffer_addch(buf, ' ');
-        }
+        if (compile_search(m, np, buf) < 0)
+          return -1;
 
-        SLIST_REMOVE_HEAD(firstpat->child, entries);
+        if (SLIST_NEXT(np, entries))
+          mutt_buffer_addch(buf, ' ');
       }
-
       mutt_buffer_addch(buf, ')');
+      break;
     }
-  }
-  else
-  {
-    char term[256];
-    char *delim = NULL;
-
-    switch (firstpat->op)
+    case MUTT_PAT_HEADER:
     {
-      case MUTT_PAT_HEADER:
-        mutt_buffer_addstr(buf, "HEADER ");
-
-        /* extract header name */
-        delim = strchr(firstpat->p.str, ':');
-        if (!delim)
-        {
-          mutt_error(_("Header search without header name: %s"), firstpat->p.str);
-          return -1;
-        }
-        *delim = '\0';
-        imap_quote_string(term, sizeof(term), firstpat->p.str, false);
-        mutt_buffer_addstr(buf, term);
-        mutt_buffer_addch(buf, ' ');
-
-        /* and field */
-        *delim = ':';
-        delim++;
-        SKIPWS(delim);
-        imap_quote_string(term, sizeof(term), delim, false);
-        mutt_buffer_addstr(buf, term);
-        break;
-      case MUTT_PAT_BODY:
-        mutt_buffer_addstr(buf, "BODY ");
-        imap_quote_string(term, sizeof(term), firstpat->p.str, false);
-        mutt_buffer_addstr(buf, term);
-        break;
-      case MUTT_PAT_WHOLE_MSG:
-        mutt_buffer_addstr(buf, "TEXT ");
-        imap_quote_string(term, sizeof(term), firstpat->p.str, false);
-        mutt_buffer_addstr(buf, term);
-        break;
-      case MUTT_PAT_SERVERSEARCH:
+      mutt_buffer_addstr(buf, "HEADER ");
+
+      /* extract header name */
+      const char *delim = strchr(pat->p.str, ':');
+      char *name = mutt_str_substr_dup(pat->p.str, delim);
+      imap_quote_string(term, sizeof(term), name, false);
+      FREE(&name);
+      mutt_buffer_addstr(buf, term);
+      mutt_buffer_addch(buf, ' ');
+
+      /* and field */
+      delim++;
+      SKIPWS(delim);
+      imap_quote_string(term, sizeof(term), delim, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    }
+    case MUTT_PAT_BODY:
+      mutt_buffer_addstr(buf, "BODY ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_WHOLE_MSG:
+      mutt_buffer_addstr(buf, "TEXT ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_SUBJECT:
+      mutt_buffer_addstr(buf, "SUBJECT ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_FROM:
+      mutt_buffer_addstr(buf, "FROM ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_TO:
+      mutt_buffer_addstr(buf, "TO ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_CC:
+      mutt_buffer_addstr(buf, "CC ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_PAT_SERVERSEARCH:
+    {
+      struct ImapAccountData *adata = imap_adata_get(m);
+      if (!(adata->capabilities & IMAP_CAP_X_GM_EXT_1))
       {
-        struct ImapAccountData *adata = imap_adata_get(m);
-        if (!(adata->capabilities & IMAP_CAP_X_GM_EXT_1))
-        {
-          mutt_error(_("Server-side custom search not supported: %s"),
-                     firstpat->p.str);
-          return -1;
-        }
+        mutt_error(_("Server-side custom search not supported: %s"), pat->p.str);
+        return -1;
       }
-        mutt_buffer_addstr(buf, "X-GM-RAW ");
-        imap_quote_string(term, sizeof(term), firstpat->p.str, false);
-        mutt_buffer_addstr(buf, term);
-        break;
     }
+      mutt_buffer_addstr(buf, "X-GM-RAW ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
   }
 
   return 0;
 }
 
+/**
+ * compile_search_selected - Convert the selected Patterns to an IMAP search
+ * @param m   Mailbox
+ * @param pat Pattern to convert
+ * @param buf Buffer for result
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * All the Patterns selected for the server are ANDed together.
+ */
+static int compile_search_selected(struct Mailbox *m, const struct Pattern *pat,
+                                   struct Buffer *buf)
+{
+  if (pat->isserver)
+  {
+    mutt_buffer_addch(buf, ' ');
+    return compile_search(m, pat, buf);
+  }
+
+  if (!pat->child)
+    return 0;
+
+  const struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat->child, entries)
+  {
+    if (compile_search_selected(m, np, buf) < 0)
+      return -1;
+  }
+  return 0;
+}
+
 /**
  * longest_common_prefix - Find longest prefix common to two strings
  * @param dest  Destination buffer
@@ -712,18 +857,19 @@ void imap_logout_all(void)
  * @param adata Imap Account data
  * @param bytes Number of bytes to read
  * @param pbar  Progress bar
+ * @param crlf  If true, keep `\r\n` line endings, e.g. for binary data
  * @retval  0 Success
  * @retval -1 Failure
  *
- * Not explicitly buffered, relies on FILE buffering.
+ * The literal is copied from the connection a block at a time.
  *
- * @note Strips `\r` from `\r\n`.
+ * @note Strips `\r` from `\r\n`, unless crlf is set.
  *       Apparently even literals use `\r\n`-terminated strings ?!
  */
 int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
-                      unsigned long bytes, struct Progress *pbar)
+                      unsigned long bytes, struct Progress *pbar, bool crlf)
 {
-  char c;
+  char chunk[16384];
   bool r = false;
   struct Buffer *buf = NULL;
 
@@ -732,9 +878,11 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
 
   mutt_debug(LL_DEBUG2, "reading %ld bytes\n", bytes);
 
-  for (unsigned long pos = 0; pos < bytes; pos++)
+  for (unsigned long pos = 0; pos < bytes;)
   {
-    if (mutt_socket_readchar(adata->conn, &c) != 1)
+    const int len = mutt_socket_readblock(adata->conn, chunk,
+                                          MIN(sizeof(chunk), bytes - pos));
+    if (len < 0)
     {
       mutt_debug(LL_DEBUG1, "error during read, %ld bytes read\n", pos);
       adata->status = IMAP_FATAL;
@@ -743,23 +891,45 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
       return -1;
     }
 
-    if (r && (c != '\n'))
-      fputc('\r', fp);
-
-    if (c == '\r')
+    if (crlf)
     {
-      r = true;
-      continue;
+      fwrite(chunk, 1, len, fp);
     }
     else
+    {
+      const char *p = chunk;
+      const char *end = chunk + len;
+
+      /* a \r at the end of the last chunk */
+      if (r && (*p != '\n'))
+        fputc('\r', fp);
       r = false;
 
-    fputc(c, fp);
+      while (p < end)
+      {
+        const char *cr = memchr(p, '\r', end - p);
+        if (!cr)
+        {
+          fwrite(p, 1, end - p, fp);
+          break;
+        }
+
+        fwrite(p, 1, cr - p, fp);
+        p = cr + 1;
+        if (p == end)
+          r = true;
+        else if (*p != '\n')
+          fputc('\r', fp);
+      }
+    }
 
-    if (pbar && !(pos % 1024))
-      mutt_progress_update(pbar, pos, -1);
+    /* report progress at every 1K boundary */
+    if (pbar && ((pos / 1024) != ((pos + len) / 1024)))
+      mutt_progress_update(pbar, pos + len, -1);
     if (C_DebugLevel >= IMAP_LOG_LTRL)
-      mutt_buffer_addch(buf, c);
+      mutt_buffer_addstr_n(buf, chunk, len);
+
+    pos += len;
   }
 
   if (C_DebugLevel >= IMAP_LOG_LTRL)
@@ -855,6 +1025,7 @@ int imap_open_connection(struct ImapAccountData *adata)
     return -1;
 
   adata->state = IMAP_CONNECTED;
+  adata->notify = false;
 
   if (imap_cmd_step(adata) != IMAP_CMD_OK)
   {
@@ -943,6 +1114,7 @@ void imap_close_connection(struct ImapAccountData *adata)
 {
   if (adata->state != IMAP_DISCONNECTED)
   {
+    mutt_poll_remove(adata->conn->fd);
     mutt_socket_close(adata->conn);
     adata->state = IMAP_DISCONNECTED;
   }
@@ -1291,14 +1463,135 @@ static int imap_status(struct ImapAccountData *adata, struct ImapMboxData *mdata
     mutt_debug(LL_DEBUG1, "Error queueing command\n");
     return rc;
   }
+  if (queue)
+    adata->status_queued = true;
   return mdata->messages;
 }
 
+/**
+ * imap_status_flush - Collect the replies to the queued STATUS commands
+ *
+ * The queued commands of every account are sent first, then the replies are
+ * read, one account at a time.  A slow server only costs one round trip, not
+ * one per mailbox, and the accounts' round trips overlap.
+ * $imap_poll_timeout limits the wait for each account.  Replies that take
+ * longer are left for the next command to read.
+ */
+void imap_status_flush(void)
+{
+  struct Account *np = NULL;
+  TAILQ_FOREACH(np, &AllAccounts, entries)
+  {
+    struct ImapAccountData *adata = np->adata;
+    if ((np->magic != MUTT_IMAP) || !adata || !adata->status_queued)
+      continue;
+
+    if (!adata->conn || (adata->conn->fd < 0) || (imap_cmd_flush(adata) <= 0))
+      adata->status_queued = false;
+  }
+
+  TAILQ_FOREACH(np, &AllAccounts, entries)
+  {
+    struct ImapAccountData *adata = np->adata;
+    if ((np->magic != MUTT_IMAP) || !adata || !adata->status_queued)
+      continue;
+
+    adata->status_queued = false;
+
+    /* A slow reply isn't worth dropping the connection for.  The next command
+     * will collect it. */
+    if ((C_ImapPollTimeout > 0) && (mutt_socket_poll(adata->conn, C_ImapPollTimeout) == 0))
+    {
+      mutt_debug(LL_DEBUG1, "STATUS replies from %s timed out\n", adata->conn->account.host);
+      continue;
+    }
+    imap_exec(adata, NULL, IMAP_CMD_NO_FLAGS);
+  }
+}
+
+/**
+ * imap_notify_set - Ask the server to report changes to an Account's mailboxes
+ * @param m Mailbox of the Account
+ * @retval  0 Success
+ * @retval -1 Failure, the mailboxes must be polled
+ *
+ * The selected mailbox gets the usual EXISTS, EXPUNGE and FETCH responses.
+ * The other mailboxes get an untagged STATUS when messages arrive or are
+ * expunged.
+ */
+static int imap_notify_set(struct Mailbox *m)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct Buffer *cmd = mutt_buffer_pool_get();
+  int count = 0;
+
+  mutt_buffer_addstr(cmd, "NOTIFY SET (SELECTED (MessageNew MessageExpunge FlagChange))");
+
+  struct MailboxNode *np = NULL;
+  STAILQ_FOREACH(np, &m->account->mailboxes, entries)
+  {
+    struct ImapMboxData *mdata = imap_mdata_get(np->mailbox);
+    if (!mdata)
+      continue;
+
+    mutt_buffer_addstr(cmd, (count == 0) ? " (MAILBOXES (" : " ");
+    mutt_buffer_addstr(cmd, mdata->munge_name);
+    /* Changes may have been missed before now */
+    mdata->notify = true;
+    mdata->notify_stale = true;
+    count++;
+  }
+  if (count != 0)
+    mutt_buffer_addstr(cmd, ") (MessageNew MessageExpunge))");
+
+  const int rc = imap_exec(adata, mutt_b2s(cmd), IMAP_CMD_NO_FLAGS);
+  mutt_buffer_pool_release(&cmd);
+
+  if (rc != IMAP_EXEC_SUCCESS)
+  {
+    mutt_debug(LL_DEBUG1, "NOTIFY SET failed, falling back to STATUS\n");
+    adata->capabilities &= ~IMAP_CAP_NOTIFY;
+    return -1;
+  }
+
+  adata->notify = true;
+  return 0;
+}
+
+/**
+ * imap_notify_poll - Read any notifications the server has sent
+ * @param adata Imap Account data
+ */
+static void imap_notify_poll(struct ImapAccountData *adata)
+{
+  while (mutt_socket_poll(adata->conn, 0) > 0)
+  {
+    const int rc = imap_cmd_step(adata);
+    if ((rc != IMAP_CMD_OK) && (rc != IMAP_CMD_CONTINUE))
+      break;
+  }
+}
+
 /**
  * imap_mbox_check_stats - Implements MxOps::mbox_check_stats()
+ *
+ * If the server supports NOTIFY, a STATUS is only sent for the mailboxes that
+ * the server has reported as changed.
  */
 int imap_mbox_check_stats(struct Mailbox *m, int flags)
 {
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  if (C_ImapNotify && adata && mdata && m->account &&
+      (adata->capabilities & IMAP_CAP_NOTIFY) && (adata->state >= IMAP_AUTHENTICATED) &&
+      ((adata->notify && mdata->notify) || (imap_notify_set(m) == 0)))
+  {
+    imap_notify_poll(adata);
+    if (!mdata->notify_stale)
+      return 0;
+  }
+
   int rc = imap_mailbox_status(m, true);
   if (rc > 0)
     rc = 0;
@@ -1351,20 +1644,30 @@ int imap_mailbox_status(struct Mailbox *m, bool queue)
  * @param pat Pattern to match
  * @retval  0 Success
  * @retval -1 Failure
+ *
+ * Let the server evaluate the parts of the Pattern that would otherwise
+ * need every message to be downloaded.  The largest subtrees that the server
+ * can express are chosen.  Their result is stored in Email.matched and the
+ * Patterns are marked with Pattern.isserver.  Everything else is left for
+ * mutt_pattern_exec().
  */
-int imap_search(struct Mailbox *m, const struct PatternHead *pat)
+int imap_search(struct Mailbox *m, struct PatternHead *pat)
 {
   struct Buffer buf;
   struct ImapAccountData *adata = imap_adata_get(m);
   for (int i = 0; i < m->msg_count; i++)
     m->emails[i]->matched = false;
 
-  if (do_search(pat, true) == 0)
+  struct Pattern *root = SLIST_FIRST(pat);
+  search_clear(root);
+  if ((search_select_and(root) == 0) && !search_select_any(root))
     return 0;
 
   mutt_buffer_init(&buf);
-  mutt_buffer_addstr(&buf, "UID SEARCH ");
-  if (compile_search(m, pat, &buf) < 0)
+  mutt_buffer_addstr(&buf, "UID SEARCH");
+  if (adata->capabilities & IMAP_CAP_ESEARCH)
+    mutt_buffer_addstr(&buf, " RETURN (ALL)");
+  if (compile_search_selected(m, root, &buf) < 0)
   {
     FREE(&buf.data);
     return -1;
@@ -1379,6 +1682,93 @@ int imap_search(struct Mailbox *m, const struct PatternHead *pat)
   return 0;
 }
 
+/**
+ * sort_criterion - Get the IMAP SORT criterion for a sort method
+ * @param method Sort method, e.g. #SORT_DATE
+ * @retval ptr  RFC5256 sort key
+ * @retval NULL The server can't sort this way
+ */
+static const char *sort_criterion(int method)
+{
+  switch (method & SORT_MASK)
+  {
+    case SORT_DATE:
+      return "DATE";
+    case SORT_FROM:
+      return "FROM";
+    case SORT_RECEIVED:
+      return "ARRIVAL";
+    case SORT_SIZE:
+      return "SIZE";
+    case SORT_SUBJECT:
+      return "SUBJECT";
+    case SORT_TO:
+      return "TO";
+    default:
+      return NULL;
+  }
+}
+
+/**
+ * imap_sort - Let the server sort the selected mailbox
+ * @param m      Mailbox
+ * @param method Sort method, e.g. #SORT_DATE
+ * @retval  0 Success, Mailbox.emails is in the server's order
+ * @retval -1 Failure, the caller should sort locally
+ *
+ * If $imap_server_sort is set and the server supports RFC5256, ask it for the
+ * order of the messages with a `UID SORT` command, rather than comparing the
+ * headers locally.  Messages that compare equal are left in the server's
+ * order (by sequence number), so $sort_aux isn't used.
+ */
+int imap_sort(struct Mailbox *m, int method)
+{
+  if (!C_ImapServerSort || !m || (m->magic != MUTT_IMAP) || (m->msg_count == 0))
+    return -1;
+
+  const char *criterion = sort_criterion(method);
+  if (!criterion)
+    return -1;
+
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  if (!adata || !mdata || (adata->mailbox != m) || (adata->state < IMAP_SELECTED) ||
+      !(adata->capabilities & IMAP_CAP_SORT))
+  {
+    return -1;
+  }
+
+  char buf[64];
+  snprintf(buf, sizeof(buf), "UID SORT (%s%s) UTF-8 ALL",
+           (method & SORT_REVERSE) ? "REVERSE " : "", criterion);
+
+  mdata->sort_result = mutt_mem_calloc(m->msg_count, sizeof(struct Email *));
+  mdata->sort_max = m->msg_count;
+  mdata->sort_count = 0;
+
+  int rc = -1;
+  if (imap_exec(adata, buf, IMAP_CMD_NO_FLAGS) != IMAP_EXEC_SUCCESS)
+    goto done;
+
+  /* The server's view of the mailbox must match ours exactly.
+   * If anything was expunged while the command ran, the results are stale. */
+  if ((m->msg_count != mdata->sort_max) || (mdata->sort_count != m->msg_count))
+  {
+    mutt_debug(LL_DEBUG1, "SORT returned %d of %d messages\n", mdata->sort_count,
+               m->msg_count);
+    goto done;
+  }
+
+  memcpy(m->emails, mdata->sort_result, m->msg_count * sizeof(struct Email *));
+  rc = 0;
+
+done:
+  FREE(&mdata->sort_result);
+  mdata->sort_count = 0;
+  mdata->sort_max = 0;
+  return rc;
+}
+
 /**
  * imap_subscribe - Subscribe to a mailbox
  * @param path      Mailbox path
@@ -2206,6 +2596,10 @@ static int imap_mbox_check(struct Mailbox *m, int *index_hint)
    * m could be NULL. Beware. */
   imap_disallow_reopen(m);
 
+  /* Nothing else happened, so fetch some of the older headers */
+  if ((rc == 0) && (imap_backfill_headers(m) > 0))
+    rc = MUTT_BACKFILL;
+
   return rc;
 }
 
@@ -50,11 +50,14 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <sys/types.h>
 #include "mx.h"
 
+struct Body;
 struct BrowserState;
 struct ConnAccount;
+struct Email;
 struct EmailList;
 struct Mailbox;
 struct Pattern;
@@ -66,11 +69,15 @@ extern char *C_ImapAuthenticators;
 
 /* These Config Variables are only used in imap/imap.c */
 extern bool C_ImapIdle;
+extern bool C_ImapNotify;
 extern bool C_ImapRfc5161;
+extern bool C_ImapServerSort;
 
 /* These Config Variables are only used in imap/message.c */
 extern char *C_ImapHeaders;
 extern long C_ImapFetchChunkSize;
+extern long C_ImapFetchWindow;
+extern long C_ImapPartialFetch;
 
 /* These Config Variables are only used in imap/command.c */
 extern bool C_ImapServernoise;
@@ -86,7 +93,11 @@ int imap_delete_mailbox(struct Mailbox *m, char *path);
 int imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close);
 int imap_path_status(const char *path, bool queue);
 int imap_mailbox_status(struct Mailbox *m, bool queue);
-int imap_search(struct Mailbox *m, const struct PatternHead *pat);
+void imap_status_flush(void);
+int imap_search(struct Mailbox *m, struct PatternHead *pat);
+int imap_fetch_part(struct Mailbox *m, struct Email *e, struct Body *b, FILE *fp);
+bool imap_part_deferred(struct Mailbox *m, struct Email *e, struct Body *b);
+int imap_sort(struct Mailbox *m, int method);
 int imap_subscribe(char *path, bool subscribe);
 int imap_complete(char *buf, size_t buflen, char *path);
 int imap_fast_trash(struct Mailbox *m, char *dest);
@@ -113,6 +124,7 @@ void imap_pretty_mailbox(char *path, size_t pathlen, const char *folder);
 
 int imap_wait_keepalive(pid_t pid);
 void imap_keepalive(void);
+bool imap_backfill_pending(struct Mailbox *m);
 
 void imap_get_parent_path(const char *path, char *buf, size_t buflen);
 void imap_clean_path(char *path, size_t plen);
@@ -135,8 +135,12 @@ typedef uint32_t ImapCapFlags;              ///< Flags, e.g. #IMAP_CAP_IMAP4
 #define IMAP_CAP_QRESYNC          (1 << 15) ///< RFC7162
 #define IMAP_CAP_LIST_EXTENDED    (1 << 16) ///< RFC5258: IMAP4 LIST Command Extensions
 #define IMAP_CAP_X_GM_EXT_1       (1 << 17) ///< https://developers.google.com/gmail/imap/imap-extensions
+#define IMAP_CAP_SORT             (1 << 18) ///< RFC5256: IMAP SORT extension
+#define IMAP_CAP_ESEARCH          (1 << 19) ///< RFC4731: IMAP4 Extension for Returning SEARCH Results
+#define IMAP_CAP_BINARY           (1 << 20) ///< RFC3516: IMAP4 Binary Content Extension
+#define IMAP_CAP_NOTIFY           (1 << 21) ///< RFC5465: IMAP NOTIFY Extension
 
-#define IMAP_CAP_ALL             ((1 << 18) - 1)
+#define IMAP_CAP_ALL             ((1 << 22) - 1)
 
 /**
  * struct ImapList - Items in an IMAP browser
@@ -189,6 +193,7 @@ struct ImapAccountData
 
   bool unicode; /* If true, we can send UTF-8, and the server will use UTF8 rather than mUTF7 */
   bool qresync; /* true, if QRESYNC is successfully ENABLE'd */
+  bool notify;  ///< true, if NOTIFY SET is active on this connection
 
   /* if set, the response parser will store results for complicated commands
    * here. */
@@ -200,6 +205,7 @@ struct ImapAccountData
   int nextcmd;
   int lastcmd;
   struct Buffer *cmdbuf;
+  bool status_queued; ///< STATUS commands are waiting to be sent
 
   char delim;
   struct Mailbox *mailbox;     /* Current selected mailbox */
@@ -228,13 +234,24 @@ struct ImapMboxData
   unsigned int messages;
   unsigned int recent;
   unsigned int unseen;
+  bool notify;       /**< Mailbox is included in the account's NOTIFY SET */
+  bool notify_stale; /**< NOTIFY has reported a change, STATUS is needed */
 
   // Cached data used only when the mailbox is opened
   struct Hash *uid_hash;
   struct Email **msn_index;   /**< look up headers by (MSN-1) */
   size_t msn_index_size;       /**< allocation size */
   unsigned int max_msn;        /**< the largest MSN fetched so far */
+  unsigned int backfill_msn;   /**< headers up to this MSN may still need fetching */
+  unsigned int backfill_size;  /**< number of headers to backfill next time */
   struct BodyCache *bcache;
+  char *partial_path;          /**< Partial copy of a message, see $imap_partial_fetch */
+  unsigned int partial_uid;    /**< UID of the message in partial_path */
+
+  // Results of a UID SORT, only valid while the command runs
+  struct Email **sort_result; /**< Emails in the order given by the server */
+  int sort_count;             /**< Number of Emails in sort_result */
+  int sort_max;               /**< Allocation size of sort_result */
 
   header_cache_t *hcache;
 };
@@ -262,7 +279,7 @@ int imap_exec_msgset(struct Mailbox *m, const char *pre, const char *post,
                      int flag, bool changed, bool invert);
 int imap_open_connection(struct ImapAccountData *adata);
 void imap_close_connection(struct ImapAccountData *adata);
-int imap_read_literal(FILE *fp, struct ImapAccountData *adata, unsigned long bytes, struct Progress *pbar);
+int imap_read_literal(FILE *fp, struct ImapAccountData *adata, unsigned long bytes, struct Progress *pbar, bool crlf);
 void imap_expunge_mailbox(struct Mailbox *m);
 int imap_login(struct ImapAccountData *adata);
 int imap_sync_message_for_copy(struct Mailbox *m, struct Email *e, struct Buffer *cmd, enum QuadOption *err_continue);
@@ -280,11 +297,13 @@ bool imap_code(const char *s);
 const char *imap_cmd_trailer(struct ImapAccountData *adata);
 int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags);
 int imap_cmd_idle(struct ImapAccountData *adata);
+int imap_cmd_flush(struct ImapAccountData *adata);
 
 /* message.c */
 void imap_edata_free(void **ptr);
 struct ImapEmailData *imap_edata_get(struct Email *e);
 int imap_read_headers(struct Mailbox *m, unsigned int msn_begin, unsigned int msn_end, bool initial_download);
+int imap_backfill_headers(struct Mailbox *m);
 char *imap_set_flags(struct Mailbox *m, struct Email *e, char *s, bool *server_changes);
 int imap_cache_del(struct Mailbox *m, struct Email *e);
 int imap_cache_clean(struct Mailbox *m);
@@ -33,6 +33,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include "imap_private.h"
@@ -45,6 +46,7 @@
 #include "bcache.h"
 #include "curs_lib.h"
 #include "globals.h"
+#include "handler.h"
 #include "hcache/hcache.h"
 #include "imap/imap.h"
 #include "mailbox.h"
@@ -54,6 +56,8 @@
 #include "mutt_socket.h"
 #include "muttlib.h"
 #include "mx.h"
+#include "ncrypt/ncrypt.h"
+#include "options.h"
 #include "progress.h"
 #include "protos.h"
 #ifdef ENABLE_NLS
@@ -65,6 +69,8 @@ struct BodyCache;
 /* These Config Variables are only used in imap/message.c */
 char *C_ImapHeaders; ///< Config: (imap) Additional email headers to download when getting index
 long C_ImapFetchChunkSize; ///< Config: (imap) Download headers in blocks of this size
+long C_ImapFetchWindow; ///< Config: (imap) Only download the newest headers when opening a mailbox
+long C_ImapPartialFetch; ///< Config: (imap) Don't download attachments larger than this when displaying a message
 
 /**
  * imap_edata_free - free ImapHeader structure
@@ -79,6 +85,7 @@ void imap_edata_free(void **ptr)
   /* this should be safe even if the list wasn't used */
   FREE(&edata->flags_system);
   FREE(&edata->flags_remote);
+  FREE(&edata->deferred);
   FREE(ptr);
 }
 
@@ -467,7 +474,7 @@ static int msg_fetch_header(struct Mailbox *m, struct ImapHeader *ih, char *buf,
   unsigned int bytes = 0;
   if (imap_get_literal_count(buf, &bytes) == 0)
   {
-    imap_read_literal(fp, adata, bytes, NULL);
+    imap_read_literal(fp, adata, bytes, NULL, false);
 
     /* we may have other fields of the FETCH _after_ the literal
      * (eg Domino puts FLAGS here). Nothing wrong with that, either.
@@ -1284,6 +1291,17 @@ int imap_read_headers(struct Mailbox *m, unsigned int msn_begin,
   mdata->reopen &= ~(IMAP_REOPEN_ALLOW | IMAP_NEWMAIL_PENDING);
   mdata->new_mail_count = 0;
 
+  /* Only fetch the newest headers now, imap_backfill_headers() will fetch
+   * the rest later.  QRESYNC can't tell us about expunges of messages we
+   * haven't seen, so it needs the full list. */
+  unsigned int backfill_msn = 0;
+  if (initial_download && (C_ImapFetchWindow > 0) && !adata->qresync &&
+      (msn_end - msn_begin + 1 > C_ImapFetchWindow))
+  {
+    backfill_msn = msn_end - C_ImapFetchWindow;
+    msn_begin = backfill_msn + 1;
+  }
+
 #ifdef USE_HCACHE
   mdata->hcache = imap_hcache_open(adata, mdata);
 
@@ -1413,6 +1431,12 @@ int imap_read_headers(struct Mailbox *m, unsigned int msn_begin,
     mx_alloc_memory(m);
   }
 
+  if (initial_download)
+  {
+    mdata->backfill_msn = backfill_msn;
+    mdata->backfill_size = C_ImapFetchWindow;
+  }
+
   mdata->reopen |= IMAP_REOPEN_ALLOW;
 
   retval = msn_end;
@@ -1426,6 +1450,71 @@ bail:
   return retval;
 }
 
+/**
+ * imap_backfill_headers - Fetch some of the headers skipped when opening
+ * @param m Imap Selected Mailbox
+ * @retval >0 Number of Emails added
+ * @retval  0 Nothing left to fetch
+ * @retval -1 Failure
+ *
+ * If $imap_fetch_window is set, only the newest headers are fetched when the
+ * mailbox is opened.  This fetches the next block of older headers, working
+ * backwards.  The blocks double in size each time, so the mailbox doesn't get
+ * resorted too often, up to $imap_fetch_chunk_size (or $imap_fetch_window) so
+ * that none of them holds up the keyboard for long.  Headers already in the
+ * header cache are skipped.  Ctrl-C stops the backfill.
+ */
+int imap_backfill_headers(struct Mailbox *m)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  if (!adata || !mdata || (adata->mailbox != m) || (mdata->backfill_msn == 0))
+    return 0;
+
+  unsigned int msn_end = MIN(mdata->backfill_msn, mdata->max_msn);
+  unsigned int size = MAX(mdata->backfill_size, 1);
+  long max_size = (C_ImapFetchChunkSize > 0) ? C_ImapFetchChunkSize : C_ImapFetchWindow;
+  if ((max_size > 0) && (size > max_size))
+    size = max_size;
+  unsigned int msn_begin = (msn_end > size) ? (msn_end - size + 1) : 1;
+  unsigned int maxuid = 0;
+  int oldmsgcount = m->msg_count;
+
+  mutt_debug(LL_DEBUG2, "Backfilling headers from %u to %u\n", msn_begin, msn_end);
+
+  while ((m->msg_count + (msn_end - msn_begin + 1)) > m->email_max)
+    mx_alloc_memory(m);
+
+#ifdef USE_HCACHE
+  mdata->hcache = imap_hcache_open(adata, mdata);
+#endif
+
+  int rc = read_headers_fetch_new(m, msn_begin, msn_end, true, &maxuid, false);
+
+#ifdef USE_HCACHE
+  imap_hcache_close(mdata);
+#endif
+
+  if (rc < 0)
+    return -1;
+
+  if (maxuid && (mdata->uid_next < maxuid + 1))
+    mdata->uid_next = maxuid + 1;
+
+  mdata->backfill_msn = msn_begin - 1;
+  if (size < (UINT_MAX / 2))
+    mdata->backfill_size = size * 2;
+
+  if (SigInt && (mdata->backfill_msn > 0))
+  {
+    SigInt = 0;
+    mdata->backfill_msn = 0;
+    mutt_message(_("Stopped fetching older headers"));
+  }
+
+  return m->msg_count - oldmsgcount;
+}
+
 /**
  * imap_append_message - Write an email back to the server
  * @param m   Mailbox
@@ -1841,6 +1930,944 @@ char *imap_set_flags(struct Mailbox *m, struct Email *e, char *s, bool *server_c
   return s;
 }
 
+/**
+ * body_section - Get the IMAP section specifier of a MIME part
+ * @param[in]  parts  List of parts to search
+ * @param[in]  b      MIME part to find
+ * @param[in]  prefix Section of the parent, e.g. "2."
+ * @param[out] buf    Buffer for the section, e.g. "2.1"
+ * @retval true The part was found
+ *
+ * The parts of a message/rfc822 are numbered as if they were the parts of the
+ * message/rfc822 itself, see RFC3501 section 6.4.5.
+ */
+static bool body_section(struct Body *parts, struct Body *b, const char *prefix,
+                         struct Buffer *buf)
+{
+  char next[128];
+  int num = 1;
+
+  for (struct Body *p = parts; p; p = p->next, num++)
+  {
+    mutt_buffer_printf(buf, "%s%d", prefix, num);
+    if (p == b)
+      return true;
+
+    struct Body *sub = p->parts;
+    if ((p->type == TYPE_MESSAGE) && sub && (sub->type == TYPE_MULTIPART))
+      sub = sub->parts;
+    if (!sub)
+      continue;
+
+    snprintf(next, sizeof(next), "%s.", mutt_b2s(buf));
+    if (body_section(sub, b, next, buf))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * msg_fetch_part - Fetch a section of an Email
+ * @param adata   Imap Account data
+ * @param uid     UID of the Email
+ * @param section Section to fetch, e.g. "2.1"
+ * @param binary  If true, ask the server to decode the section (RFC3516)
+ * @param crlf    If true, keep `\r\n` line endings
+ * @param fp      File to write to
+ * @retval  0 Success
+ * @retval -1 Failure
+ */
+static int msg_fetch_part(struct ImapAccountData *adata, unsigned int uid,
+                          const char *section, bool binary, bool crlf, FILE *fp)
+{
+  char buf[256];
+  struct Progress progress;
+  unsigned int bytes = 0;
+  bool fetched = false;
+  bool output_progress = !isendwin();
+  int rc;
+
+  snprintf(buf, sizeof(buf), "UID FETCH %u %s.PEEK[%s]", uid,
+           binary ? "BINARY" : "BODY", section);
+
+  imap_cmd_start(adata, buf);
+  do
+  {
+    rc = imap_cmd_step(adata);
+    if (rc != IMAP_CMD_CONTINUE)
+      break;
+
+    char *pc = imap_next_word(adata->buf);
+    pc = imap_next_word(pc);
+    if (!mutt_str_startswith(pc, "FETCH", CASE_IGNORE))
+      continue;
+
+    while (*pc)
+    {
+      pc = imap_next_word(pc);
+      if (pc[0] == '(')
+        pc++;
+      if (!mutt_str_startswith(pc, "BINARY[", CASE_IGNORE) &&
+          !mutt_str_startswith(pc, "BODY[", CASE_IGNORE))
+      {
+        continue;
+      }
+
+      pc = imap_next_word(pc);
+      if (imap_get_literal_count(pc, &bytes) < 0)
+      {
+        imap_error("msg_fetch_part()", buf);
+        return -1;
+      }
+      if (output_progress)
+      {
+        mutt_progress_init(&progress, _("Fetching message..."),
+                           MUTT_PROGRESS_SIZE, C_NetInc, bytes);
+      }
+      if (imap_read_literal(fp, adata, bytes, output_progress ? &progress : NULL, crlf) < 0)
+        return -1;
+      /* pick up trailing line */
+      rc = imap_cmd_step(adata);
+      if (rc != IMAP_CMD_CONTINUE)
+        return -1;
+      pc = adata->buf;
+
+      fetched = true;
+    }
+  } while (rc == IMAP_CMD_CONTINUE);
+
+  if ((rc != IMAP_CMD_OK) || !fetched || !imap_code(adata->buf))
+    return -1;
+
+  return 0;
+}
+
+/**
+ * imap_fetch_part - Fetch a single MIME part of an Email
+ * @param m  Mailbox
+ * @param e  Email
+ * @param b  MIME part of the Email
+ * @param fp File to write the part to
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * Rather than downloading the whole message, only the part is fetched.  If the
+ * server supports BINARY (RFC3516), it will also undo any base64 or
+ * quoted-printable encoding for us, saving bandwidth.
+ *
+ * On success, the part has been appended to fp and b has been updated to
+ * point at it.  If the server decoded the part, b's encoding will be binary.
+ */
+int imap_fetch_part(struct Mailbox *m, struct Email *e, struct Body *b, FILE *fp)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  if (!adata || (adata->mailbox != m) || !e || !e->content || !b || !fp)
+    return -1;
+  if (!(adata->capabilities & IMAP_CAP_IMAP4REV1))
+    return -1;
+
+  struct Buffer *section = mutt_buffer_pool_get();
+  struct Body *top = (e->content->type == TYPE_MULTIPART) ? e->content->parts : e->content;
+  int rc = -1;
+
+  if (!body_section(top, b, "", section))
+    goto done;
+
+  bool binary = (adata->capabilities & IMAP_CAP_BINARY) &&
+                ((b->encoding == ENC_BASE64) || (b->encoding == ENC_QUOTED_PRINTABLE));
+  LOFF_T offset = ftello(fp);
+  unsigned int uid = imap_edata_get(e)->uid;
+
+  mutt_debug(LL_DEBUG2, "fetching part %s of UID %u\n", mutt_b2s(section), uid);
+
+  /* Decoded binary data mustn't have its line endings touched */
+  if (binary && (msg_fetch_part(adata, uid, mutt_b2s(section), true,
+                                (b->type != TYPE_TEXT), fp) == 0))
+  {
+    b->encoding = ENC_BINARY;
+    rc = 0;
+  }
+  else
+  {
+    /* The server may refuse to decode the part, e.g. [UNKNOWN-CTE] */
+    if (binary && ((fflush(fp) != 0) || (ftruncate(fileno(fp), offset) != 0) ||
+                   (fseeko(fp, offset, SEEK_SET) != 0)))
+    {
+      goto done;
+    }
+    rc = msg_fetch_part(adata, uid, mutt_b2s(section), false, false, fp);
+  }
+
+  if (fflush(fp) != 0)
+    rc = -1;
+
+  if (rc == 0)
+  {
+    b->offset = offset;
+    b->length = ftello(fp) - offset;
+    b->remote_length = 0;
+  }
+
+done:
+  mutt_buffer_pool_release(&section);
+  return rc;
+}
+
+/**
+ * struct ImapParens - A parenthesised list from an IMAP response
+ *
+ * A node is either a list (of child nodes), a string or NIL.
+ */
+struct ImapParens
+{
+  char *str;              ///< Atom or string, NULL for a list or NIL
+  bool is_list;           ///< This node is a list
+  struct ImapParens *child; ///< First member of the list
+  struct ImapParens *next;  ///< Next member of the parent list
+};
+
+/**
+ * parens_free - Free a parsed IMAP list
+ * @param[out] ptr List to free
+ */
+static void parens_free(struct ImapParens **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct ImapParens *l = *ptr;
+  while (l)
+  {
+    struct ImapParens *next = l->next;
+    parens_free(&l->child);
+    FREE(&l->str);
+    FREE(&l);
+    l = next;
+  }
+  *ptr = NULL;
+}
+
+/**
+ * parens_parse - Parse a parenthesised list from an IMAP response
+ * @param[in,out] s String to parse, will be advanced past the item
+ * @retval ptr  Parsed item
+ * @retval NULL Failure
+ *
+ * Literals aren't supported; the caller will have to fall back to something
+ * else.
+ */
+static struct ImapParens *parens_parse(char **s)
+{
+  char *p = *s;
+  SKIPWS(p);
+
+  struct ImapParens *l = mutt_mem_calloc(1, sizeof(struct ImapParens));
+
+  if (*p == '(')
+  {
+    struct ImapParens **tail = &l->child;
+    l->is_list = true;
+    p++;
+    while (true)
+    {
+      SKIPWS(p);
+      if (*p == ')')
+      {
+        p++;
+        break;
+      }
+      if (*p == '\0')
+        goto fail;
+
+      *tail = parens_parse(&p);
+      if (!*tail)
+        goto fail;
+      tail = &(*tail)->next;
+    }
+  }
+  else if (*p == '"')
+  {
+    struct Buffer *buf = mutt_buffer_pool_get();
+    for (p++; *p && (*p != '"'); p++)
+    {
+      if ((*p == '\\') && p[1])
+        p++;
+      mutt_buffer_addch(buf, *p);
+    }
+    if (*p != '"')
+    {
+      mutt_buffer_pool_release(&buf);
+      goto fail;
+    }
+    p++;
+    l->str = mutt_str_strdup(mutt_b2s(buf));
+    mutt_buffer_pool_release(&buf);
+  }
+  else
+  {
+    const char *start = p;
+    while (*p && !IS_SPACE(*p) && (*p != '(') && (*p != ')') && (*p != '{'))
+      p++;
+    if ((p == start) || (*p == '{'))
+      goto fail;
+    if (mutt_str_strncasecmp(start, "NIL", p - start) != 0)
+      l->str = mutt_str_substr_dup(start, p);
+  }
+
+  *s = p;
+  return l;
+
+fail:
+  parens_free(&l);
+  return NULL;
+}
+
+/**
+ * parens_nth - Get a member of an IMAP list
+ * @param l List
+ * @param n Index of member, starting at 0
+ * @retval ptr  Member
+ * @retval NULL List is too short
+ */
+static struct ImapParens *parens_nth(struct ImapParens *l, int n)
+{
+  if (!l || !l->is_list)
+    return NULL;
+
+  struct ImapParens *np = l->child;
+  for (; np && (n > 0); n--)
+    np = np->next;
+  return np;
+}
+
+/**
+ * bodystructure_param - Find a parameter in a BODYSTRUCTURE
+ * @param params List of attribute/value pairs
+ * @param attr   Attribute to find, e.g. "BOUNDARY"
+ * @retval ptr  Value of the parameter
+ * @retval NULL Not found
+ */
+static const char *bodystructure_param(struct ImapParens *params, const char *attr)
+{
+  if (!params || !params->is_list)
+    return NULL;
+
+  for (struct ImapParens *np = params->child; np && np->next; np = np->next->next)
+  {
+    if (mutt_str_strcasecmp(np->str, attr) == 0)
+      return np->next->str;
+  }
+  return NULL;
+}
+
+/**
+ * bodystructure_is_multipart - Is this part of a BODYSTRUCTURE a multipart?
+ * @param bs BODYSTRUCTURE of the part
+ * @retval true It's a multipart
+ */
+static bool bodystructure_is_multipart(struct ImapParens *bs)
+{
+  return bs && bs->is_list && bs->child && bs->child->is_list;
+}
+
+/**
+ * bodystructure_secure - Is this multipart signed or encrypted?
+ * @param bs BODYSTRUCTURE of a multipart
+ * @retval true It's a multipart/signed or multipart/encrypted
+ */
+static bool bodystructure_secure(struct ImapParens *bs)
+{
+  /* BODYSTRUCTURE: (parts) subtype (params) ... */
+  struct ImapParens *sub = bs->child;
+  while (sub && sub->is_list)
+    sub = sub->next;
+  if (!sub)
+    return false;
+
+  return (mutt_str_strcasecmp(sub->str, "signed") == 0) ||
+         (mutt_str_strcasecmp(sub->str, "encrypted") == 0);
+}
+
+/**
+ * bodystructure_defer - Can we avoid downloading this part?
+ * @param bs BODYSTRUCTURE of a single part
+ * @retval true The part isn't needed to display the message
+ *
+ * Large parts that NeoMutt can't display anyway are only fetched when the user
+ * opens them, see $imap_partial_fetch.
+ */
+static bool bodystructure_defer(struct ImapParens *bs)
+{
+  const char *type = parens_nth(bs, 0) ? parens_nth(bs, 0)->str : NULL;
+  const char *subtype = parens_nth(bs, 1) ? parens_nth(bs, 1)->str : NULL;
+  const char *size = parens_nth(bs, 6) ? parens_nth(bs, 6)->str : NULL;
+  long octets = 0;
+
+  if (!type || !subtype || (mutt_str_atol(size, &octets) < 0) || (octets <= C_ImapPartialFetch))
+    return false;
+
+  struct Body *b = mutt_body_new();
+  b->type = mutt_check_mime_type(type);
+  b->subtype = mutt_str_strdup(subtype);
+  bool defer = (b->type != TYPE_MULTIPART) && !mutt_can_decode(b);
+  mutt_body_free(&b);
+
+  return defer;
+}
+
+/**
+ * partial_request - Decide which sections of a multipart to fetch
+ * @param[in]  bs       BODYSTRUCTURE of the multipart
+ * @param[in]  prefix   Section of the multipart, e.g. "2."
+ * @param[in]  secure   If true, the parts are signed or encrypted
+ * @param[out] items    FETCH items to request
+ * @param[out] deferred Sections that won't be fetched, and their sizes
+ * @retval true Success
+ */
+static bool partial_request(struct ImapParens *bs, const char *prefix, bool secure,
+                            struct Buffer *items, char **deferred)
+{
+  char section[128];
+  int num = 0;
+
+  struct ImapParens *np = bs->child;
+  for (; np && np->is_list; np = np->next)
+  {
+    num++;
+    snprintf(section, sizeof(section), "%s%d", prefix, num);
+    mutt_buffer_add_printf(items, " BODY.PEEK[%s.MIME]", section);
+
+    if (bodystructure_is_multipart(np))
+    {
+      /* BODYSTRUCTURE: (parts) subtype (params) ... */
+      struct ImapParens *sub = np->child;
+      while (sub && sub->is_list)
+        sub = sub->next;
+      if (!sub || !bodystructure_param(sub->next, "BOUNDARY"))
+        return false;
+
+      mutt_str_strcat(section, sizeof(section), ".");
+      if (!partial_request(np, section, secure || bodystructure_secure(np), items, deferred))
+        return false;
+    }
+    else if (!secure && bodystructure_defer(np))
+    {
+      /* Remember the size, the part will be empty in the partial copy */
+      mutt_str_strcat(section, sizeof(section), ":");
+      mutt_str_strcat(section, sizeof(section), parens_nth(np, 6)->str);
+      mutt_str_append_item(deferred, section, ' ');
+    }
+    else
+    {
+      mutt_buffer_add_printf(items, " BODY.PEEK[%s]", section);
+    }
+  }
+
+  return num > 0;
+}
+
+/**
+ * struct PartialSection - A section of a message fetched from the server
+ */
+struct PartialSection
+{
+  char *section; ///< Section, e.g. "2.MIME"
+  LOFF_T offset; ///< Offset in the temporary file
+  size_t length; ///< Length of the section
+};
+
+/**
+ * partial_find - Find a fetched section
+ * @param sections Fetched sections
+ * @param count    Number of sections
+ * @param section  Section to find, e.g. "2.MIME"
+ * @retval ptr  Section
+ * @retval NULL Not fetched
+ */
+static struct PartialSection *partial_find(struct PartialSection *sections,
+                                           int count, const char *section)
+{
+  for (int i = 0; i < count; i++)
+    if (mutt_str_strcasecmp(sections[i].section, section) == 0)
+      return &sections[i];
+  return NULL;
+}
+
+/**
+ * partial_copy - Copy a fetched section into the message
+ * @param sections Fetched sections
+ * @param count    Number of sections
+ * @param section  Section to copy, e.g. "2.MIME"
+ * @param fp_in    Temporary file holding the sections
+ * @param fp_out   Message file
+ * @retval  0 Success
+ * @retval -1 Failure
+ */
+static int partial_copy(struct PartialSection *sections, int count,
+                        const char *section, FILE *fp_in, FILE *fp_out)
+{
+  struct PartialSection *ps = partial_find(sections, count, section);
+  if (!ps)
+    return -1;
+  if (fseeko(fp_in, ps->offset, SEEK_SET) != 0)
+    return -1;
+  return mutt_file_copy_bytes(fp_in, fp_out, ps->length);
+}
+
+/**
+ * partial_assemble - Rebuild a multipart from its fetched sections
+ * @param bs       BODYSTRUCTURE of the multipart
+ * @param prefix   Section of the multipart, e.g. "2."
+ * @param sections Fetched sections
+ * @param count    Number of sections
+ * @param fp_in    Temporary file holding the sections
+ * @param fp_out   Message file
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * Parts that weren't fetched are left empty.  The preamble and epilogue are
+ * lost, but the structure matches that of the original message.
+ */
+static int partial_assemble(struct ImapParens *bs, const char *prefix,
+                            struct PartialSection *sections, int count,
+                            FILE *fp_in, FILE *fp_out)
+{
+  char section[128];
+  char item[256];
+  int num = 0;
+
+  struct ImapParens *np = bs->child;
+  while (np && np->is_list)
+    np = np->next;
+  const char *boundary = np ? bodystructure_param(np->next, "BOUNDARY") : NULL;
+  if (!boundary)
+    return -1;
+
+  for (np = bs->child; np && np->is_list; np = np->next)
+  {
+    num++;
+    snprintf(section, sizeof(section), "%s%d", prefix, num);
+    fprintf(fp_out, "--%s\n", boundary);
+
+    snprintf(item, sizeof(item), "%s.MIME", section);
+    if (partial_copy(sections, count, item, fp_in, fp_out) < 0)
+      return -1;
+
+    if (bodystructure_is_multipart(np))
+    {
+      mutt_str_strcat(section, sizeof(section), ".");
+      if (partial_assemble(np, section, sections, count, fp_in, fp_out) < 0)
+        return -1;
+    }
+    else if (partial_find(sections, count, section) &&
+             (partial_copy(sections, count, section, fp_in, fp_out) < 0))
+    {
+      return -1;
+    }
+    fputc('\n', fp_out);
+  }
+  fprintf(fp_out, "--%s--\n", boundary);
+
+  return 0;
+}
+
+/**
+ * fold_literals - Read a response, turning any literals into quoted strings
+ * @param adata Imap Account data
+ * @param buf   Buffer for the response
+ * @retval #IMAP_CMD_CONTINUE Success, buf may be empty if it couldn't be parsed
+ * @retval num                Response from imap_cmd_step(), the command finished
+ *
+ * Literals inside a response, e.g. a long filename in a BODYSTRUCTURE, are
+ * sent on the following line.  Fold them back in, so the response can be
+ * parsed in one go.
+ */
+static int fold_literals(struct ImapAccountData *adata, struct Buffer *buf)
+{
+  mutt_buffer_strcpy(buf, adata->buf);
+
+  while (true)
+  {
+    size_t len = mutt_buffer_len(buf);
+    char *lit = strrchr(buf->data, '{');
+    unsigned int bytes = 0;
+    if (!lit || (len < 3) || (buf->data[len - 1] != '}') ||
+        (imap_get_literal_count(lit, &bytes) < 0))
+    {
+      return IMAP_CMD_CONTINUE;
+    }
+
+    *lit = '\0';
+    mutt_buffer_fix_dptr(buf);
+
+    int rc = imap_cmd_step(adata);
+    if (rc != IMAP_CMD_CONTINUE)
+      return rc;
+    if (strlen(adata->buf) < bytes)
+    {
+      mutt_buffer_reset(buf);
+      return IMAP_CMD_CONTINUE;
+    }
+
+    mutt_buffer_addch(buf, '"');
+    for (unsigned int i = 0; i < bytes; i++)
+    {
+      if ((adata->buf[i] == '"') || (adata->buf[i] == '\\'))
+        mutt_buffer_addch(buf, '\\');
+      mutt_buffer_addch(buf, adata->buf[i]);
+    }
+    mutt_buffer_addch(buf, '"');
+    mutt_buffer_addstr(buf, adata->buf + bytes);
+  }
+}
+
+/**
+ * msg_fetch_partial - Fetch the parts of a message needed to display it
+ * @param[in]  m        Mailbox
+ * @param[in]  e        Email
+ * @param[in]  fp       File to write the message to
+ * @param[out] deferred Sections that weren't downloaded
+ * @retval  0 Success
+ * @retval -1 Failure, fetch the whole message instead
+ *
+ * The BODYSTRUCTURE tells us which parts are too big to be worth fetching.  The
+ * headers and the rest of the parts are fetched in a single command, then the
+ * message is reassembled with the large parts left empty.
+ */
+static int msg_fetch_partial(struct Mailbox *m, struct Email *e, FILE *fp, char **deferred)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapParens *bs = NULL;
+  struct PartialSection *sections = NULL;
+  int count = 0;
+  int rc = -1;
+  char buf[128];
+
+  unsigned int uid = imap_edata_get(e)->uid;
+  snprintf(buf, sizeof(buf), "UID FETCH %u BODYSTRUCTURE", uid);
+
+  struct Buffer *resp = mutt_buffer_pool_get();
+  imap_cmd_start(adata, buf);
+  int step;
+  do
+  {
+    step = imap_cmd_step(adata);
+    if (step != IMAP_CMD_CONTINUE)
+      break;
+
+    char *pc = imap_next_word(adata->buf);
+    pc = imap_next_word(pc);
+    if (!mutt_str_startswith(pc, "FETCH", CASE_IGNORE))
+      continue;
+
+    step = fold_literals(adata, resp);
+    if (step != IMAP_CMD_CONTINUE)
+      break;
+
+    pc = strstr(resp->data, "BODYSTRUCTURE ");
+    if (pc && !bs)
+    {
+      pc += 14;
+      bs = parens_parse(&pc);
+    }
+  } while (step == IMAP_CMD_CONTINUE);
+  mutt_buffer_pool_release(&resp);
+
+  if ((step != IMAP_CMD_OK) || !bodystructure_is_multipart(bs))
+    goto done;
+
+  struct Buffer *items = mutt_buffer_pool_get();
+  mutt_buffer_addstr(items, "BODY.PEEK[HEADER]");
+  /* The signature covers the whole of a signed part, so it can't be split */
+  bool ok = partial_request(bs, "", bodystructure_secure(bs), items, deferred);
+  if (!ok || !*deferred)
+  {
+    /* Nothing to gain */
+    mutt_buffer_pool_release(&items);
+    goto done;
+  }
+
+  mutt_debug(LL_DEBUG2, "UID %u, not fetching sections: %s\n", uid, *deferred);
+
+  FILE *fp_tmp = mutt_file_mkstemp();
+  if (!fp_tmp)
+  {
+    mutt_buffer_pool_release(&items);
+    goto done;
+  }
+
+  struct Buffer *cmd = mutt_buffer_pool_get();
+  mutt_buffer_printf(cmd, "UID FETCH %u (%s)", uid, mutt_b2s(items));
+  mutt_buffer_pool_release(&items);
+  imap_cmd_start(adata, mutt_b2s(cmd));
+  mutt_buffer_pool_release(&cmd);
+
+  do
+  {
+    step = imap_cmd_step(adata);
+    if (step != IMAP_CMD_CONTINUE)
+      break;
+
+    char *pc = imap_next_word(adata->buf);
+    pc = imap_next_word(pc);
+    if (!mutt_str_startswith(pc, "FETCH", CASE_IGNORE))
+      continue;
+
+    while (*pc)
+    {
+      pc = imap_next_word(pc);
+      if (pc[0] == '(')
+        pc++;
+      if (!mutt_str_startswith(pc, "BODY[", CASE_IGNORE))
+        continue;
+
+      char *end = strchr(pc, ']');
+      if (!end)
+        break;
+
+      mutt_mem_realloc(&sections, (count + 1) * sizeof(struct PartialSection));
+      struct PartialSection *ps = &sections[count++];
+      ps->section = mutt_str_substr_dup(pc + 5, end);
+      ps->offset = ftello(fp_tmp);
+      ps->length = 0;
+
+      unsigned int bytes = 0;
+      pc = imap_next_word(pc);
+      if (imap_get_literal_count(pc, &bytes) < 0)
+        continue; /* NIL or "" */
+
+      if (imap_read_literal(fp_tmp, adata, bytes, NULL, false) < 0)
+        break;
+      ps->length = ftello(fp_tmp) - ps->offset;
+
+      /* pick up trailing line */
+      step = imap_cmd_step(adata);
+      if (step != IMAP_CMD_CONTINUE)
+        break;
+      pc = adata->buf;
+    }
+  } while (step == IMAP_CMD_CONTINUE);
+
+  if ((step == IMAP_CMD_OK) && imap_code(adata->buf) && (fflush(fp_tmp) == 0) &&
+      (partial_copy(sections, count, "HEADER", fp_tmp, fp) == 0) &&
+      (partial_assemble(bs, "", sections, count, fp_tmp, fp) == 0) && (fflush(fp) == 0))
+  {
+    rc = 0;
+  }
+  mutt_file_fclose(&fp_tmp);
+
+done:
+  for (int i = 0; i < count; i++)
+    FREE(&sections[i].section);
+  FREE(&sections);
+  parens_free(&bs);
+  if (rc != 0)
+    FREE(deferred);
+  return rc;
+}
+
+/**
+ * msg_partial_open - Open a partial copy of a message
+ * @param m Mailbox
+ * @param e Email
+ * @retval ptr  Partial copy of the message
+ * @retval NULL Failure, or not worth it
+ *
+ * The most recent partial copy is kept, since displaying a message usually
+ * opens it more than once.
+ */
+static FILE *msg_partial_open(struct Mailbox *m, struct Email *e)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  struct ImapEmailData *edata = imap_edata_get(e);
+  char path[PATH_MAX];
+  char *deferred = NULL;
+
+  if (mdata->partial_path && (mdata->partial_uid == edata->uid))
+  {
+    FILE *fp = fopen(mdata->partial_path, "r");
+    if (fp)
+      return fp;
+  }
+
+  mutt_mktemp(path, sizeof(path));
+  FILE *fp = mutt_file_fopen(path, "w+");
+  if (!fp)
+    return NULL;
+
+  if (msg_fetch_partial(m, e, fp, &deferred) < 0)
+  {
+    mutt_file_fclose(&fp);
+    unlink(path);
+    return NULL;
+  }
+
+  if (mdata->partial_path)
+    unlink(mdata->partial_path);
+  mutt_str_replace(&mdata->partial_path, path);
+  mdata->partial_uid = edata->uid;
+
+  FREE(&edata->deferred);
+  edata->deferred = deferred;
+
+  rewind(fp);
+  return fp;
+}
+
+/**
+ * body_copy_offsets - Copy the location of MIME parts between two parses
+ * @param dst MIME parts to update
+ * @param src MIME parts parsed from the current copy of the message
+ * @retval true The structures matched
+ */
+static bool body_copy_offsets(struct Body *dst, struct Body *src)
+{
+  for (; dst && src; dst = dst->next, src = src->next)
+  {
+    if (dst->type != src->type)
+      return false;
+
+    dst->offset = src->offset;
+    dst->hdr_offset = src->hdr_offset;
+    dst->length = src->length;
+    dst->remote_length = src->remote_length;
+    dst->encoding = src->encoding;
+    if (dst->email && src->email)
+      dst->email->offset = src->email->offset;
+
+    if (!body_copy_offsets(dst->parts, src->parts))
+      return false;
+  }
+
+  return !dst && !src;
+}
+
+/**
+ * deferred_find - Look up a section in the list of deferred ones
+ * @param deferred Deferred sections, e.g. "2:40960 3.1:2048"
+ * @param section  Section to find, e.g. "3.1"
+ * @retval ptr  Size of the section, e.g. "2048"
+ * @retval NULL The section was downloaded
+ */
+static const char *deferred_find(const char *deferred, const char *section)
+{
+  size_t len = mutt_str_strlen(section);
+  for (const char *p = deferred; p && *p;)
+  {
+    if ((mutt_str_strncmp(p, section, len) == 0) && (p[len] == ':'))
+      return p + len + 1;
+    p = strchr(p, ' ');
+    if (p)
+      p++;
+  }
+  return NULL;
+}
+
+/**
+ * body_deferred_lengths - Record the sizes of the deferred parts
+ * @param parts    MIME parts parsed from a partial copy of the message
+ * @param prefix   Section of the parts, e.g. "2."
+ * @param deferred Deferred sections, e.g. "2:40960 3.1:2048"
+ *
+ * The deferred parts are empty in the partial copy, but the attachment menu
+ * should show the size the server told us.  Body.length still describes the
+ * partial copy.
+ */
+static void body_deferred_lengths(struct Body *parts, const char *prefix, const char *deferred)
+{
+  char section[128];
+  int num = 1;
+
+  for (struct Body *b = parts; b; b = b->next, num++)
+  {
+    snprintf(section, sizeof(section), "%s%d", prefix, num);
+    if (b->type == TYPE_MULTIPART)
+    {
+      mutt_str_strcat(section, sizeof(section), ".");
+      body_deferred_lengths(b->parts, section, deferred);
+      continue;
+    }
+
+    const char *size = deferred_find(deferred, section);
+    if (size)
+      b->remote_length = strtol(size, NULL, 10);
+  }
+}
+
+/**
+ * msg_update_parts - Make the MIME parts match the copy of the message
+ * @param e       Email
+ * @param fp      Copy of the message
+ * @param partial true if this is a partial copy
+ *
+ * A partial copy of a message has the same structure as the whole message, but
+ * the parts are in different places.  Rather than reparse the message, which
+ * would free Bodys that may still be in use, move the existing ones.
+ */
+static void msg_update_parts(struct Email *e, FILE *fp, bool partial)
+{
+  struct ImapEmailData *edata = imap_edata_get(e);
+
+  if (e->content->parts && (partial || edata->partial))
+  {
+    struct Body *parts = e->content->parts;
+    e->content->parts = NULL;
+    mutt_parse_part(fp, e->content);
+
+    if (body_copy_offsets(parts, e->content->parts))
+    {
+      mutt_body_free(&e->content->parts);
+      e->content->parts = parts;
+    }
+    else
+    {
+      mutt_debug(LL_DEBUG1, "MIME structure of UID %u changed\n", edata->uid);
+      mutt_body_free(&parts);
+    }
+    rewind(fp);
+  }
+  else if (partial)
+  {
+    /* Parse it now, while we know which parts are missing */
+    mutt_parse_part(fp, e->content);
+    if (WithCrypto)
+      e->security = crypt_query(e->content);
+    rewind(fp);
+  }
+
+  if (partial)
+    body_deferred_lengths(e->content->parts, "", edata->deferred);
+
+  if (!partial)
+    FREE(&edata->deferred);
+  edata->partial = partial;
+}
+
+/**
+ * imap_part_deferred - Was this MIME part left out of the message?
+ * @param m Mailbox
+ * @param e Email
+ * @param b MIME part
+ * @retval true The part wasn't downloaded, use imap_fetch_part()
+ */
+bool imap_part_deferred(struct Mailbox *m, struct Email *e, struct Body *b)
+{
+  struct ImapEmailData *edata = imap_edata_get(e);
+  if (!imap_mdata_get(m) || !edata || !edata->partial || !edata->deferred || !e->content)
+    return false;
+
+  struct Buffer *section = mutt_buffer_pool_get();
+  struct Body *top = (e->content->type == TYPE_MULTIPART) ? e->content->parts : e->content;
+  bool deferred = false;
+
+  if (body_section(top, b, "", section))
+    deferred = (deferred_find(edata->deferred, mutt_b2s(section)) != NULL);
+
+  mutt_buffer_pool_release(&section);
+  return deferred;
+}
+
 /**
  * imap_msg_open - Implements MxOps::msg_open()
  */
@@ -1856,6 +2883,7 @@ int imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
   struct Progress progress;
   unsigned int uid;
   bool retried = false;
+  bool partial = false;
   bool read;
   int rc;
 
@@ -1875,11 +2903,30 @@ int imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
   if (msg->fp)
   {
     if (imap_edata_get(e)->parsed)
+    {
+      msg_update_parts(e, msg->fp, false);
       return 0;
+    }
     else
       goto parsemsg;
   }
 
+  /* When displaying a large message, leave out the big attachments.
+   * A signed or encrypted message must be fetched whole. */
+  if (OptPartialFetch && (C_ImapPartialFetch > 0) &&
+      (adata->capabilities & IMAP_CAP_IMAP4REV1) &&
+      (e->content->type == TYPE_MULTIPART) && (e->content->length > C_ImapPartialFetch) &&
+      (mutt_str_strcasecmp(e->content->subtype, "signed") != 0) &&
+      (mutt_str_strcasecmp(e->content->subtype, "encrypted") != 0))
+  {
+    msg->fp = msg_partial_open(m, e);
+    if (msg->fp)
+    {
+      partial = true;
+      goto parsemsg;
+    }
+  }
+
   /* This function is called in a few places after endwin()
    * e.g. mutt_pipe_message(). */
   output_progress = !isendwin();
@@ -1952,7 +2999,7 @@ int imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
             mutt_progress_init(&progress, _("Fetching message..."),
                                MUTT_PROGRESS_SIZE, C_NetInc, bytes);
           }
-          if (imap_read_literal(msg->fp, adata, bytes, output_progress ? &progress : NULL) < 0)
+          if (imap_read_literal(msg->fp, adata, bytes, output_progress ? &progress : NULL, false) < 0)
           {
             goto bail;
           }
@@ -2014,6 +3061,14 @@ parsemsg:
     mutt_set_flag(m, e, MUTT_NEW, read);
   }
 
+  if (partial)
+  {
+    /* The line count and length would be wrong, wait for the whole message */
+    rewind(msg->fp);
+    msg_update_parts(e, msg->fp, true);
+    return 0;
+  }
+
   e->lines = 0;
   fgets(buf, sizeof(buf), msg->fp);
   while (!feof(msg->fp))
@@ -2036,6 +3091,7 @@ parsemsg:
     goto parsemsg;
   }
 
+  msg_update_parts(e, msg->fp, false);
   return 0;
 
 bail:
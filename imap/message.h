@@ -40,12 +40,14 @@ struct ImapEmailData
   bool replied : 1;
 
   bool parsed : 1;
+  bool partial : 1; ///< The MIME parts were parsed from a partial copy of the message
 
   unsigned int uid; /**< 32-bit Message UID */
   unsigned int msn; /**< Message Sequence Number */
 
   char *flags_system;
   char *flags_remote;
+  char *deferred;   /**< Sections that weren't downloaded, and their sizes, e.g. "2:40960 3.1:2048" */
 };
 
 /**
@@ -56,6 +56,7 @@
 #include "mailbox.h"
 #include "message.h"
 #include "mutt_account.h"
+#include "mutt_poll.h"
 #include "options.h"
 
 /* These Config Variables are only used in imap/util.c */
@@ -80,6 +81,7 @@ void imap_adata_free(void **ptr)
 
   if (adata->conn)
   {
+    mutt_poll_remove(adata->conn->fd);
     if (adata->conn->conn_close)
       adata->conn->conn_close(adata->conn);
     FREE(&adata->conn);
@@ -216,7 +218,13 @@ void imap_mdata_cache_reset(struct ImapMboxData *mdata)
   FREE(&mdata->msn_index);
   mdata->msn_index_size = 0;
   mdata->max_msn = 0;
+  mdata->backfill_msn = 0;
+  mdata->backfill_size = 0;
   mutt_bcache_close(&mdata->bcache);
+  if (mdata->partial_path)
+    unlink(mdata->partial_path);
+  FREE(&mdata->partial_path);
+  mdata->partial_uid = 0;
 }
 
 /**
@@ -1046,6 +1054,21 @@ void imap_unmunge_mbox_name(bool unicode, char *s)
   FREE(&buf);
 }
 
+/**
+ * imap_backfill_pending - Are there headers still to be fetched?
+ * @param m Mailbox
+ * @retval true The Mailbox was only partially loaded, see $imap_fetch_window
+ */
+bool imap_backfill_pending(struct Mailbox *m)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  if (!adata || (adata->mailbox != m) || (adata->state < IMAP_SELECTED))
+    return false;
+
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  return mdata && (mdata->backfill_msn > 0);
+}
+
 /**
  * imap_keepalive - poll the current folder to keep the connection alive
  */
@@ -474,8 +474,8 @@ static void update_index_threaded(struct Context *ctx, int check, int oldcount)
     mutt_sort_headers(ctx, false);
   }
 
-  /* uncollapse threads with new mail */
-  if (C_UncollapseNew)
+  /* uncollapse threads with new mail, but not for old emails backfilled */
+  if (C_UncollapseNew && (check != MUTT_BACKFILL))
   {
     if (check == MUTT_REOPENED)
     {
@@ -568,6 +568,18 @@ void update_index(struct Menu *menu, struct Context *ctx, int check, int oldcoun
       oldcount = 0; /* invalid message number! */
   }
 
+#ifdef USE_IMAP
+  /* The server only answered the limit for the messages it had then.
+   * A search may also have replaced that answer since. */
+  if (ctx->pattern && (ctx->mailbox->magic == MUTT_IMAP) &&
+      ((check == MUTT_REOPENED) || (oldcount < ctx->mailbox->msg_count)))
+  {
+    if (imap_search(ctx->mailbox, ctx->limit_pattern) < 0)
+      mutt_debug(LL_DEBUG1, "Couldn't repeat the server search for the limit\n");
+    OptSearchInvalid = true;
+  }
+#endif
+
   if ((C_Sort & SORT_MASK) == SORT_THREADS)
     update_index_threaded(ctx, check, oldcount);
   else
@@ -1112,7 +1124,8 @@ int mutt_index_menu(void)
 
         OptSearchInvalid = true;
       }
-      else if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED) || (check == MUTT_FLAGS))
+      else if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED) ||
+               (check == MUTT_FLAGS) || (check == MUTT_BACKFILL))
       {
         /* notify the user of new mail */
         if (check == MUTT_REOPENED)
@@ -1590,6 +1590,16 @@ struct ConfigDef MuttVars[] = {
   ** a FETCH per set of this size instead of a single FETCH for all new
   ** headers.
   */
+  { "imap_fetch_window",            DT_LONG, R_NONE, &C_ImapFetchWindow, 0 },
+  /*
+  ** .pp
+  ** When set to a value greater than 0, only the newest headers (up to this
+  ** many) will be downloaded when opening a mailbox.  The older headers are
+  ** then fetched in ever larger blocks while the index is idle.  This lets
+  ** you start reading a very large mailbox much sooner.
+  ** .pp
+  ** This has no effect if $$imap_qresync is in use.
+  */
   { "imap_headers",     DT_STRING, R_INDEX, &C_ImapHeaders, 0 },
   /*
   ** .pp
@@ -1638,6 +1648,14 @@ struct ConfigDef MuttVars[] = {
   ** .pp
   ** This variable defaults to the value of $$imap_user.
   */
+  { "imap_notify",              DT_BOOL, R_NONE, &C_ImapNotify, false },
+  /*
+  ** .pp
+  ** When \fIset\fP, and the server supports the IMAP NOTIFY extension,
+  ** NeoMutt asks the server to report changes to the other mailboxes of
+  ** the account.  Only the mailboxes that the server reports as changed
+  ** are sent a STATUS command when checking for new mail, see $$mail_check.
+  */
   { "imap_oauth_refresh_command", DT_STRING, R_NONE|F_SENSITIVE, &C_ImapOauthRefreshCommand, 0 },
   /*
   ** .pp
@@ -1646,6 +1664,18 @@ struct ConfigDef MuttVars[] = {
   ** run on every connection attempt that uses the OAUTHBEARER authentication
   ** mechanism.  See "$oauth" for details.
   */
+  { "imap_partial_fetch",       DT_LONG, R_NONE, &C_ImapPartialFetch, 0 },
+  /*
+  ** .pp
+  ** When set to a value greater than 0, attachments larger than this many
+  ** bytes won't be downloaded when an IMAP message is displayed, if NeoMutt
+  ** can't display them anyway.  They will be fetched when you open them
+  ** from the attachment menu.  This makes reading a message with a large
+  ** attachment much quicker over a slow link.
+  ** .pp
+  ** This has no effect on signed or encrypted parts, or if the whole
+  ** message is already in the $$message_cachedir.
+  */
   { "imap_pass",        DT_STRING,  R_NONE|F_SENSITIVE, &C_ImapPass, 0 },
   /*
   ** .pp
@@ -1713,6 +1743,19 @@ struct ConfigDef MuttVars[] = {
   ** If your connection seems to freeze at login, try unsetting this. See also
   ** https://github.com/neomutt/neomutt/issues/1689
   */
+  { "imap_server_sort",         DT_BOOL, R_INDEX|R_RESORT, &C_ImapServerSort, false },
+  /*
+  ** .pp
+  ** When \fIset\fP, NeoMutt will ask the IMAP server to sort the current
+  ** mailbox, using the SORT extension (RFC5256), if the server supports it.
+  ** This is only done for the $$sort methods \fIdate\fP, \fIfrom\fP,
+  ** \fIreceived\fP, \fIsize\fP, \fIsubject\fP and \fIto\fP.  Other methods,
+  ** including \fIthreads\fP, are always sorted locally.
+  ** .pp
+  ** The server's rules differ slightly from NeoMutt's, e.g. \fIfrom\fP
+  ** compares the mailbox name, rather than the real name.  Messages that sort
+  ** equally are left in the server's order; $$sort_aux is not used.
+  */
   { "imap_servernoise",         DT_BOOL, R_NONE, &C_ImapServernoise, true },
   /*
   ** .pp
@@ -2495,6 +2538,18 @@ struct ConfigDef MuttVars[] = {
   ** when you are at the end of a message and invoke the \fC<next-page>\fP
   ** function.
   */
+  { "pager_stream_size", DT_LONG|DT_NOT_NEGATIVE, R_NONE, &C_PagerStreamSize, 1048576 },
+  /*
+  ** .pp
+  ** Messages larger than this many bytes are decoded in the background when
+  ** they are displayed in the internal pager.  The first screen is shown as
+  ** soon as it has been decoded and the rest of the message is added while
+  ** you read.  Leaving the pager stops the decoding.
+  ** .pp
+  ** Encrypted and signed messages, and messages shown through a
+  ** $$display_filter, are always decoded before they are displayed.  A value
+  ** of 0 disables this feature.
+  */
   { "pgp_auto_decode", DT_BOOL, R_NONE, &C_PgpAutoDecode, false },
   /*
   ** .pp
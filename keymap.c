@@ -37,12 +37,14 @@
 #include "mutt/mutt.h"
 #include "mutt.h"
 #include "keymap.h"
+#include "context.h"
 #include "curs_lib.h"
 #include "functions.h"
 #include "globals.h"
 #include "mutt_commands.h"
 #include "mutt_curses.h"
 #include "mutt_logging.h"
+#include "mutt_poll.h"
 #include "mutt_window.h"
 #include "ncrypt/ncrypt.h"
 #include "opcodes.h"
@@ -50,9 +52,6 @@
 #ifdef USE_IMAP
 #include "imap/imap.h"
 #endif
-#ifdef USE_INOTIFY
-#include "monitor.h"
-#endif
 
 /**
  * Menus - Menu name lookup table
@@ -581,6 +580,19 @@ int km_dokey(int menu)
   {
     int i = (C_Timeout > 0) ? C_Timeout : 60;
 #ifdef USE_IMAP
+    /* only wait briefly if the index still has headers to fetch, see
+     * $imap_fetch_window, but not in the middle of a key sequence */
+    if ((menu == MENU_MAIN) && (pos == 0) &&
+        imap_backfill_pending(Context ? Context->mailbox : NULL))
+    {
+      mutt_getch_timeout(50);
+      tmp = mutt_getch();
+      mutt_getch_timeout(-1);
+      if (C_ImapKeepalive && (tmp.ch == -2))
+        imap_keepalive();
+      goto gotkey;
+    }
+
     /* keepalive may need to run more frequently than C_Timeout allows */
     if (C_ImapKeepalive)
     {
@@ -596,11 +608,7 @@ int km_dokey(int menu)
           /* If a timeout was not received, or the window was resized, exit the
            * loop now.  Otherwise, continue to loop until reaching a total of
            * $timeout seconds.  */
-#ifdef USE_INOTIFY
-          if ((tmp.ch != -2) || SigWinch || MonitorFilesChanged)
-#else
-          if ((tmp.ch != -2) || SigWinch)
-#endif
+          if ((tmp.ch != -2) || SigWinch || PollSourceReady)
             goto gotkey;
           i -= C_ImapKeepalive;
           imap_keepalive();
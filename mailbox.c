@@ -182,8 +182,7 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
       case MUTT_MAILDIR:
       case MUTT_MH:
       case MUTT_NOTMUCH:
-        if (mx_mbox_check_stats(m_check, 0) == 0)
-          MailboxCount++;
+        mx_mbox_check_stats(m_check, 0);
         break;
       default:; /* do nothing */
     }
@@ -198,11 +197,6 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
     mutt_menu_set_current_redraw(REDRAW_SIDEBAR);
   }
 #endif
-
-  if (!m_check->has_new)
-    m_check->notified = false;
-  else if (!m_check->notified)
-    MailboxNotify++;
 }
 
 /**
@@ -390,6 +384,25 @@ int mutt_mailbox_check(struct Mailbox *m_cur, int force)
     np->mailbox->first_check_stats_done = true;
   }
 
+#ifdef USE_IMAP
+  /* The IMAP mailboxes only queued a STATUS command, collect the replies */
+  imap_status_flush();
+#endif
+
+  /* Count after the flush, so the IMAP replies of this check are included */
+  STAILQ_FOREACH(np, &AllMailboxes, entries)
+  {
+    if (!np->mailbox->has_new)
+    {
+      np->mailbox->notified = false;
+      continue;
+    }
+
+    MailboxCount++;
+    if (!np->mailbox->notified)
+      MailboxNotify++;
+  }
+
   return MailboxCount;
 }
 
@@ -59,6 +59,136 @@
 #define MMC_NEW_DIR (1 << 0) ///< 'new' directory changed
 #define MMC_CUR_DIR (1 << 1) ///< 'cur' directory changed
 
+/**
+ * struct MaildirDirReader - Read the names in a directory
+ *
+ * Where possible, the entries are fetched in large batches using
+ * getdents64(), which makes many fewer round trips on network filesystems.
+ */
+struct MaildirDirReader
+{
+#ifdef HAVE_GETDENTS64
+  int fd;    ///< Directory file descriptor
+  char *buf; ///< Batch of directory entries
+  long len;  ///< Number of bytes in buf
+  long pos;  ///< Offset of the next entry in buf
+#else
+  DIR *dirp; ///< Directory stream
+#endif
+};
+
+#ifdef HAVE_GETDENTS64
+/// Size of a batch of directory entries
+#define MAILDIR_DENTS_SIZE (128 * 1024)
+#endif
+
+/**
+ * maildir_dir_open - Open a directory for reading
+ * @param dr   Directory reader
+ * @param path Path to the directory
+ * @retval true Success
+ */
+static bool maildir_dir_open(struct MaildirDirReader *dr, const char *path)
+{
+#ifdef HAVE_GETDENTS64
+  dr->fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dr->fd < 0)
+    return false;
+  dr->buf = mutt_mem_malloc(MAILDIR_DENTS_SIZE);
+  dr->len = 0;
+  dr->pos = 0;
+  return true;
+#else
+  dr->dirp = opendir(path);
+  return dr->dirp;
+#endif
+}
+
+/**
+ * maildir_dir_next - Get the next directory entry
+ * @param[in]  dr     Directory reader
+ * @param[out] is_dir Set to true if the entry is known to be a directory
+ * @retval ptr  Name of the entry
+ * @retval NULL No more entries
+ */
+static const char *maildir_dir_next(struct MaildirDirReader *dr, bool *is_dir)
+{
+#ifdef HAVE_GETDENTS64
+  if (dr->pos >= dr->len)
+  {
+    ssize_t len = getdents64(dr->fd, dr->buf, MAILDIR_DENTS_SIZE);
+    if (len <= 0)
+      return NULL;
+    dr->len = len;
+    dr->pos = 0;
+  }
+
+  struct dirent64 *de = (struct dirent64 *) (dr->buf + dr->pos);
+  dr->pos += de->d_reclen;
+  *is_dir = (de->d_type == DT_DIR);
+  return de->d_name;
+#else
+  struct dirent *de = readdir(dr->dirp);
+  if (!de)
+    return NULL;
+#ifdef DT_DIR
+  *is_dir = (de->d_type == DT_DIR);
+#else
+  *is_dir = false;
+#endif
+  return de->d_name;
+#endif
+}
+
+/**
+ * maildir_dir_close - Close a directory
+ * @param dr Directory reader
+ */
+static void maildir_dir_close(struct MaildirDirReader *dr)
+{
+#ifdef HAVE_GETDENTS64
+  close(dr->fd);
+  FREE(&dr->buf);
+#else
+  closedir(dr->dirp);
+#endif
+}
+
+/**
+ * maildir_dir_stats_get - Get the cached counts of a subdirectory
+ * @param m        Mailbox
+ * @param dir_name Subdirectory, "new" or "cur"
+ * @param sb       Current stat info for the subdirectory
+ * @retval ptr Cached counts (may not be valid)
+ */
+static struct MaildirDirStats *maildir_dir_stats_get(struct Mailbox *m,
+                                                     const char *dir_name, struct stat *sb)
+{
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata)
+  {
+    mdata = maildir_mdata_new();
+    m->mdata = mdata;
+    m->free_mdata = maildir_mdata_free;
+  }
+
+  struct MaildirDirStats *ds = (dir_name[0] == 'n') ? &mdata->stats_new : &mdata->stats_cur;
+  if (!ds->valid)
+    return ds;
+
+  struct timespec mtime;
+  struct timespec ctime;
+  mutt_file_get_stat_timespec(&mtime, sb, MUTT_STAT_MTIME);
+  mutt_file_get_stat_timespec(&ctime, sb, MUTT_STAT_CTIME);
+  if ((ds->ino != sb->st_ino) || (mutt_file_timespec_compare(&ds->mtime, &mtime) != 0) ||
+      (mutt_file_timespec_compare(&ds->ctime, &ctime) != 0))
+  {
+    ds->valid = false;
+  }
+
+  return ds;
+}
+
 /**
  * maildir_check_dir - Check for new mail / mail counts
  * @param m           Mailbox to check
@@ -67,25 +197,36 @@
  * @param check_stats if true, count total, new, and flagged messages
  *
  * Checks the specified maildir subdir (cur or new) for new mail or mail counts.
+ *
+ * The counts are taken from the filenames alone.  They are cached until the
+ * directory is modified, so an unchanged directory isn't read again.
  */
 static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
                               bool check_new, bool check_stats)
 {
-  DIR *dirp = NULL;
-  struct dirent *de = NULL;
+  struct MaildirDirReader dr;
+  struct MaildirDirStats *ds = NULL;
+  const char *name = NULL;
+  bool is_dir = false;
   char *p = NULL;
   struct stat sb;
+  struct stat sb_msg;
+  int msg_count = 0;
+  int msg_unread = 0;
+  int msg_flagged = 0;
+  bool has_new = false;
 
   struct Buffer *path = mutt_buffer_pool_get();
   struct Buffer *msgpath = mutt_buffer_pool_get();
   mutt_buffer_printf(path, "%s/%s", mutt_b2s(m->pathbuf), dir_name);
 
+  bool have_sb = (stat(mutt_b2s(path), &sb) == 0);
+
   /* when $mail_check_recent is set, if the new/ directory hasn't been modified since
    * the user last exited the m, then we know there is no recent mail.  */
   if (check_new && C_MailCheckRecent)
   {
-    if ((stat(mutt_b2s(path), &sb) == 0) &&
-        (mutt_file_stat_timespec_compare(&sb, MUTT_STAT_MTIME, &m->last_visited) < 0))
+    if (have_sb && (mutt_file_stat_timespec_compare(&sb, MUTT_STAT_MTIME, &m->last_visited) < 0))
     {
       check_new = false;
     }
@@ -94,45 +235,65 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   if (!(check_new || check_stats))
     goto cleanup;
 
-  dirp = opendir(mutt_b2s(path));
-  if (!dirp)
+  if (check_stats && have_sb)
+  {
+    ds = maildir_dir_stats_get(m, dir_name, &sb);
+    if (ds->valid && (!check_new || !C_MailCheckRecent ||
+                      (ds->new_checked &&
+                       (mutt_file_timespec_compare(&ds->last_visited, &m->last_visited) == 0))))
+    {
+      m->msg_count += ds->msg_count;
+      m->msg_unread += ds->msg_unread;
+      m->msg_flagged += ds->msg_flagged;
+      if (check_new && (C_MailCheckRecent ? ds->has_new : (ds->msg_unread > 0)))
+        m->has_new = true;
+      goto cleanup;
+    }
+  }
+
+  /* A change made in the same second as the directory's mtime might not be
+   * seen, so only cache the counts of a directory that has settled. */
+  bool cacheable = ds && (sb.st_mtime < time(NULL));
+  bool new_checked = check_new;
+
+  if (!maildir_dir_open(&dr, mutt_b2s(path)))
   {
     m->magic = MUTT_UNKNOWN;
     goto cleanup;
   }
 
-  while ((de = readdir(dirp)))
+  while ((name = maildir_dir_next(&dr, &is_dir)))
   {
-    if (*de->d_name == '.')
+    if ((*name == '.') || is_dir)
       continue;
 
-    p = strstr(de->d_name, ":2,");
+    p = strstr(name, ":2,");
     if (p && strchr(p + 3, 'T'))
       continue;
 
     if (check_stats)
     {
-      m->msg_count++;
+      msg_count++;
       if (p && strchr(p + 3, 'F'))
-        m->msg_flagged++;
+        msg_flagged++;
     }
     if (!p || !strchr(p + 3, 'S'))
     {
       if (check_stats)
-        m->msg_unread++;
+        msg_unread++;
       if (check_new)
       {
         if (C_MailCheckRecent)
         {
-          mutt_buffer_printf(msgpath, "%s/%s", mutt_b2s(path), de->d_name);
+          mutt_buffer_printf(msgpath, "%s/%s", mutt_b2s(path), name);
           /* ensure this message was received since leaving this m */
-          if ((stat(mutt_b2s(msgpath), &sb) == 0) &&
-              (mutt_file_stat_timespec_compare(&sb, MUTT_STAT_CTIME, &m->last_visited) <= 0))
+          if ((stat(mutt_b2s(msgpath), &sb_msg) == 0) &&
+              (mutt_file_stat_timespec_compare(&sb_msg, MUTT_STAT_CTIME, &m->last_visited) <= 0))
           {
             continue;
           }
         }
-        m->has_new = true;
+        has_new = true;
         check_new = false;
         if (!check_stats)
           break;
@@ -140,7 +301,27 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
     }
   }
 
-  closedir(dirp);
+  maildir_dir_close(&dr);
+
+  m->msg_count += msg_count;
+  m->msg_unread += msg_unread;
+  m->msg_flagged += msg_flagged;
+  if (has_new)
+    m->has_new = true;
+
+  if (cacheable)
+  {
+    ds->valid = true;
+    ds->ino = sb.st_ino;
+    mutt_file_get_stat_timespec(&ds->mtime, &sb, MUTT_STAT_MTIME);
+    mutt_file_get_stat_timespec(&ds->ctime, &sb, MUTT_STAT_CTIME);
+    ds->msg_count = msg_count;
+    ds->msg_unread = msg_unread;
+    ds->msg_flagged = msg_flagged;
+    ds->new_checked = new_checked && C_MailCheckRecent;
+    ds->has_new = has_new;
+    ds->last_visited = m->last_visited;
+  }
 
 cleanup:
   mutt_buffer_pool_release(&path);
@@ -542,11 +723,25 @@ static int maildir_mbox_check_stats(struct Mailbox *m, int flags)
   m->msg_flagged = 0;
   m->msg_new = 0;
 
+#ifdef USE_INOTIFY
+  /* The monitor keeps the counts of 'cur' up to date, 'new' is still read */
+  if (mutt_monitor_get_stats(m) != 0)
+  {
+    bool has_new = m->has_new;
+    m->has_new = false;
+    maildir_check_dir(m, "cur", C_MaildirCheckCur, check_stats);
+    mutt_monitor_set_stats(m);
+    m->has_new |= has_new;
+  }
+
+  maildir_check_dir(m, "new", check_new, check_stats);
+#else
   maildir_check_dir(m, "new", check_new, check_stats);
 
   check_new = !m->has_new && C_MaildirCheckCur;
   if (check_new || check_stats)
     maildir_check_dir(m, "cur", check_new, check_stats);
+#endif
 
   return 0;
 }
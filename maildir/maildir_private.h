@@ -38,6 +38,26 @@ struct Mailbox;
 struct Message;
 struct Progress;
 
+/**
+ * struct MaildirDirStats - Cached message counts of a Maildir subdirectory
+ *
+ * The counts are valid while the directory's inode, mtime and ctime haven't
+ * changed.
+ */
+struct MaildirDirStats
+{
+  bool valid;               ///< Counts have been cached
+  ino_t ino;                ///< Inode of the directory
+  struct timespec mtime;    ///< Mtime of the directory when it was read
+  struct timespec ctime;    ///< Ctime of the directory when it was read
+  int msg_count;            ///< Number of messages
+  int msg_unread;           ///< Number of unread messages
+  int msg_flagged;          ///< Number of flagged messages
+  bool new_checked;         ///< has_new was checked against last_visited
+  bool has_new;             ///< Directory has mail received since last_visited
+  struct timespec last_visited; ///< Mailbox::last_visited used for has_new
+};
+
 /**
  * struct MaildirMboxData - Maildir-specific Mailbox data - @extends Mailbox
  */
@@ -45,6 +65,8 @@ struct MaildirMboxData
 {
   struct timespec mtime_cur;
   mode_t mh_umask;
+  struct MaildirDirStats stats_new; ///< Cached counts of the 'new' directory
+  struct MaildirDirStats stats_cur; ///< Cached counts of the 'cur' directory
 };
 
 /**
@@ -91,7 +113,9 @@ int             mh_msg_save_hcache (struct Mailbox *m, struct Email *e);
 void                    maildir_canon_filename (struct Buffer *dest, const char *src);
 void                    maildir_delayed_parsing(struct Mailbox *m, struct Maildir **md, struct Progress *progress);
 size_t                  maildir_hcache_keylen  (const char *fn);
+void                    maildir_mdata_free     (void **ptr);
 struct MaildirMboxData *maildir_mdata_get      (struct Mailbox *m);
+struct MaildirMboxData *maildir_mdata_new      (void);
 int                     maildir_mh_open_message(struct Mailbox *m, struct Message *msg, int msgno, bool is_maildir);
 int                     maildir_move_to_mailbox(struct Mailbox *m, struct Maildir **ptr);
 int                     maildir_parse_dir      (struct Mailbox *m, struct Maildir ***last, const char *subdir, int *count, struct Progress *progress);
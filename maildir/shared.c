@@ -75,7 +75,7 @@ char *C_MhSeqFlagged; ///< Config: MH sequence for flagged message
 char *C_MhSeqReplied; ///< Config: MH sequence to tag replied messages
 char *C_MhSeqUnseen;  ///< Config: MH sequence for unseen messages
 
-#define INS_SORT_THRESHOLD 6
+#define MAILDIR_READAHEAD 16 ///< Number of files to open ahead of the parser
 
 /**
  * maildir_mdata_free - Free data attached to the Mailbox
@@ -478,165 +478,121 @@ size_t maildir_hcache_keylen(const char *fn)
 }
 
 /**
- * md_cmp_inode - Compare two Maildirs by inode number
- * @param a First  Maildir
- * @param b Second Maildir
+ * md_cmp_path - qsort callback to sort Maildirs by path
+ * @param a First  Maildir to compare
+ * @param b Second Maildir to compare
  * @retval -1 a precedes b
  * @retval  0 a and b are identical
  * @retval  1 b precedes a
  */
-static int md_cmp_inode(struct Maildir *a, struct Maildir *b)
+static int md_cmp_path(const void *a, const void *b)
 {
-  return a->inode - b->inode;
+  const struct Maildir *ma = *(struct Maildir const *const *) a;
+  const struct Maildir *mb = *(struct Maildir const *const *) b;
+
+  return strcmp(ma->email->path, mb->email->path);
 }
 
 /**
- * md_cmp_path - Compare two Maildirs by path
- * @param a First  Maildir
- * @param b Second Maildir
- * @retval -1 a precedes b
- * @retval  0 a and b are identical
- * @retval  1 b precedes a
+ * maildir_list_to_array - Copy a Maildir list into an array
+ * @param[in]  list Maildir list
+ * @param[out] num  Number of entries
+ * @retval ptr Array of Maildir entries
  */
-static int md_cmp_path(struct Maildir *a, struct Maildir *b)
+static struct Maildir **maildir_list_to_array(struct Maildir *list, size_t *num)
 {
-  return strcmp(a->email->path, b->email->path);
+  size_t count = 0;
+  for (struct Maildir *md = list; md; md = md->next)
+    count++;
+
+  struct Maildir **arr = mutt_mem_malloc(count * sizeof(*arr));
+  count = 0;
+  for (struct Maildir *md = list; md; md = md->next)
+    arr[count++] = md;
+
+  *num = count;
+  return arr;
 }
 
 /**
- * maildir_merge_lists - Merge two maildir lists
- * @param left    First  Maildir to merge
- * @param right   Second Maildir to merge
- * @param cmp     Comparison function for sorting
- * @retval ptr Merged Maildir
+ * maildir_array_to_list - Relink a Maildir list in the order of an array
+ * @param arr Array of Maildir entries
+ * @param num Number of entries
+ * @retval ptr Head of the Maildir list
  */
-static struct Maildir *maildir_merge_lists(struct Maildir *left, struct Maildir *right,
-                                           int (*cmp)(struct Maildir *, struct Maildir *))
+static struct Maildir *maildir_array_to_list(struct Maildir **arr, size_t num)
 {
-  struct Maildir *head = NULL;
-  struct Maildir *tail = NULL;
-
-  if (left && right)
-  {
-    if (cmp(left, right) < 0)
-    {
-      head = left;
-      left = left->next;
-    }
-    else
-    {
-      head = right;
-      right = right->next;
-    }
-  }
-  else
-  {
-    if (left)
-      return left;
-    else
-      return right;
-  }
-
-  tail = head;
-
-  while (left && right)
-  {
-    if (cmp(left, right) < 0)
-    {
-      tail->next = left;
-      left = left->next;
-    }
-    else
-    {
-      tail->next = right;
-      right = right->next;
-    }
-    tail = tail->next;
-  }
-
-  if (left)
-  {
-    tail->next = left;
-  }
-  else
-  {
-    tail->next = right;
-  }
-
-  return head;
+  for (size_t i = 1; i < num; i++)
+    arr[i - 1]->next = arr[i];
+  arr[num - 1]->next = NULL;
+  return arr[0];
 }
 
 /**
- * maildir_ins_sort - Sort maildirs using an insertion sort
- * @param list    Maildir list to sort
- * @param cmp     Comparison function for sorting
- * @retval ptr Sort Maildir list
+ * maildir_sort_inode - Sort a Maildir list by inode number
+ * @param list Maildir list to sort
+ * @retval ptr Sorted Maildir list
+ *
+ * Reading the files in inode order improves the disk locality.  The list is
+ * sorted using a stable radix sort, a byte at a time.  Passes in which every
+ * inode has the same byte are skipped.
  */
-static struct Maildir *maildir_ins_sort(struct Maildir *list,
-                                        int (*cmp)(struct Maildir *, struct Maildir *))
+static struct Maildir *maildir_sort_inode(struct Maildir *list)
 {
-  struct Maildir *tmp = NULL, *last = NULL, *back = NULL;
+  if (!list || !list->next)
+    return list;
 
-  struct Maildir *ret = list;
-  list = list->next;
-  ret->next = NULL;
+  size_t num = 0;
+  struct Maildir **arr = maildir_list_to_array(list, &num);
+  struct Maildir **tmp = mutt_mem_malloc(num * sizeof(*tmp));
 
-  while (list)
+  for (size_t shift = 0; shift < (sizeof(ino_t) * 8); shift += 8)
   {
-    last = NULL;
-    back = list->next;
-    for (tmp = ret; tmp && cmp(tmp, list) <= 0; tmp = tmp->next)
-      last = tmp;
-
-    list->next = tmp;
-    if (last)
-      last->next = list;
-    else
-      ret = list;
+    size_t counts[256] = { 0 };
+    for (size_t i = 0; i < num; i++)
+      counts[((uint64_t) arr[i]->inode >> shift) & 0xff]++;
+
+    if (counts[((uint64_t) arr[0]->inode >> shift) & 0xff] == num)
+      continue;
 
-    list = back;
+    size_t pos = 0;
+    for (size_t i = 0; i < 256; i++)
+    {
+      size_t c = counts[i];
+      counts[i] = pos;
+      pos += c;
+    }
+
+    for (size_t i = 0; i < num; i++)
+      tmp[counts[((uint64_t) arr[i]->inode >> shift) & 0xff]++] = arr[i];
+
+    struct Maildir **swap = arr;
+    arr = tmp;
+    tmp = swap;
   }
 
-  return ret;
+  list = maildir_array_to_list(arr, num);
+  FREE(&arr);
+  FREE(&tmp);
+  return list;
 }
 
 /**
- * maildir_sort - Sort Maildir list
- * @param list    Maildirs to sort
- * @param len     Number of Maildirs in the list
- * @param cmp     Comparison function for sorting
- * @retval ptr Sort Maildir list
+ * maildir_sort_path - Sort a Maildir list by path
+ * @param list Maildir list to sort
+ * @retval ptr Sorted Maildir list
  */
-static struct Maildir *maildir_sort(struct Maildir *list, size_t len,
-                                    int (*cmp)(struct Maildir *, struct Maildir *))
+static struct Maildir *maildir_sort_path(struct Maildir *list)
 {
-  struct Maildir *left = list;
-  struct Maildir *right = list;
-  size_t c = 0;
-
   if (!list || !list->next)
-  {
     return list;
-  }
-
-  if ((len != (size_t)(-1)) && (len <= INS_SORT_THRESHOLD))
-    return maildir_ins_sort(list, cmp);
-
-  list = list->next;
-  while (list && list->next)
-  {
-    right = right->next;
-    list = list->next->next;
-    c++;
-  }
-
-  list = right;
-  right = right->next;
-  list->next = 0;
 
-  left = maildir_sort(left, c, cmp);
-  right = maildir_sort(right, c, cmp);
-  return maildir_merge_lists(left, right, cmp);
+  size_t num = 0;
+  struct Maildir **arr = maildir_list_to_array(list, &num);
+  qsort(arr, num, sizeof(*arr), md_cmp_path);
+  list = maildir_array_to_list(arr, num);
+  FREE(&arr);
+  return list;
 }
 
 /**
@@ -651,32 +607,30 @@ static void mh_sort_natural(struct Mailbox *m, struct Maildir **md)
   if (!m || !md || !*md || (m->magic != MUTT_MH) || (C_Sort != SORT_ORDER))
     return;
   mutt_debug(LL_DEBUG3, "maildir: sorting %s into natural order\n", mutt_b2s(m->pathbuf));
-  *md = maildir_sort(*md, (size_t) -1, md_cmp_path);
+  *md = maildir_sort_path(*md);
 }
 
 /**
- * skip_duplicates - Find the first non-duplicate message
- * @param[in]  p    Maildir to start
- * @param[out] last Previous Maildir
- * @retval ptr Next Maildir
+ * maildir_open_ahead - Open a message file that will be parsed soon
+ * @param m  Mailbox
+ * @param md Maildir entry
+ * @retval >=0 File descriptor
+ * @retval -1  Error
+ *
+ * Ask the kernel to start reading the file in, while earlier files are being
+ * parsed.
  */
-static struct Maildir *skip_duplicates(struct Maildir *p, struct Maildir **last)
+static int maildir_open_ahead(struct Mailbox *m, struct Maildir *md)
 {
-  /* Skip ahead to the next non-duplicate message.
-   *
-   * p should never reach NULL, because we couldn't have reached this point
-   * unless there was a message that needed to be parsed.
-   *
-   * The check for p->header_parsed is likely unnecessary since the dupes will
-   * most likely be at the head of the list.  but it is present for consistency
-   * with the check at the top of the for() loop in maildir_delayed_parsing().
-   */
-  while (!p->email || p->header_parsed)
-  {
-    *last = p;
-    p = p->next;
-  }
-  return p;
+  char fn[PATH_MAX];
+  snprintf(fn, sizeof(fn), "%s/%s", mutt_b2s(m->pathbuf), md->email->path);
+
+  int fd = open(fn, O_RDONLY);
+#ifdef HAVE_POSIX_FADVISE
+  if (fd >= 0)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+  return fd;
 }
 
 /**
@@ -684,45 +638,56 @@ static struct Maildir *skip_duplicates(struct Maildir *p, struct Maildir **last)
  * @param[in]  m  Mailbox
  * @param[out] md Maildir to parse
  * @param[in]  progress Progress bar
+ *
+ * The messages that need parsing are sorted by inode.  First, as many as
+ * possible are restored from the header cache.  Then the rest are parsed,
+ * while the next few files are opened and read ahead.
  */
 void maildir_delayed_parsing(struct Mailbox *m, struct Maildir **md, struct Progress *progress)
 {
   struct Maildir *p = NULL, *last = NULL;
   char fn[PATH_MAX];
-  int count;
-  bool sort = false;
+  int count = 0;
+
+  for (p = *md; p && (!p->email || p->header_parsed); p = p->next)
+  {
+    last = p;
+    count++;
+  }
+
+  if (!p)
+  {
+    mh_sort_natural(m, md);
+    return;
+  }
+
+  mutt_debug(LL_DEBUG3, "maildir: need to sort %s by inode\n", mutt_b2s(m->pathbuf));
+  p = maildir_sort_inode(p);
+  if (!last)
+    *md = p;
+  else
+    last->next = p;
+
+  size_t num_parse = 0;
+  for (struct Maildir *q = p; q; q = q->next)
+    num_parse++;
+  struct Maildir **parse = mutt_mem_malloc(num_parse * sizeof(*parse));
+  num_parse = 0;
 
 #ifdef USE_HCACHE
   header_cache_t *hc = mutt_hcache_open(C_HeaderCache, mutt_b2s(m->pathbuf), NULL);
+  const char *key = NULL;
+  size_t keylen = 0;
 #endif
 
-  for (p = *md, count = 0; p; p = p->next, count++)
+  for (; p; p = p->next)
   {
-    if (!(p && p->email && !p->header_parsed))
-    {
-      last = p;
+    if (!p->email || p->header_parsed)
       continue;
-    }
-
-    if (!m->quiet && progress)
-      mutt_progress_update(progress, count, -1);
-
-    if (!sort)
-    {
-      mutt_debug(LL_DEBUG3, "maildir: need to sort %s by inode\n", mutt_b2s(m->pathbuf));
-      p = maildir_sort(p, (size_t) -1, md_cmp_inode);
-      if (!last)
-        *md = p;
-      else
-        last->next = p;
-      sort = true;
-      p = skip_duplicates(p, &last);
-      snprintf(fn, sizeof(fn), "%s/%s", mutt_b2s(m->pathbuf), p->email->path);
-    }
 
+#ifdef USE_HCACHE
     snprintf(fn, sizeof(fn), "%s/%s", mutt_b2s(m->pathbuf), p->email->path);
 
-#ifdef USE_HCACHE
     struct stat lastchanged = { 0 };
     int ret = 0;
     if (C_MaildirHeaderCacheVerify)
@@ -730,8 +695,6 @@ void maildir_delayed_parsing(struct Mailbox *m, struct Maildir **md, struct Prog
       ret = stat(fn, &lastchanged);
     }
 
-    const char *key = NULL;
-    size_t keylen = 0;
     if (m->magic == MUTT_MH)
     {
       key = p->email->path;
@@ -753,40 +716,70 @@ void maildir_delayed_parsing(struct Mailbox *m, struct Maildir **md, struct Prog
       mutt_email_free(&p->email);
       p->email = e;
       if (m->magic == MUTT_MAILDIR)
+      {
+        /* The filename is the authority on the flags */
+        e->trash = false;
+        e->deleted = false;
         maildir_parse_flags(p->email, fn);
+      }
+      mutt_hcache_free(hc, &data);
+
+      if (!m->quiet && progress)
+        mutt_progress_update(progress, count, -1);
+      count++;
+      continue;
     }
-    else
-    {
+    mutt_hcache_free(hc, &data);
 #endif
 
-      if (maildir_parse_message(m->magic, fn, p->email->old, p->email))
-      {
-        p->header_parsed = 1;
-#ifdef USE_HCACHE
-        if (m->magic == MUTT_MH)
-        {
-          key = p->email->path;
-          keylen = strlen(key);
-        }
-        else
-        {
-          key = p->email->path + 3;
-          keylen = maildir_hcache_keylen(key);
-        }
-        mutt_hcache_store(hc, key, keylen, p->email, 0);
-#endif
-      }
-      else
-        mutt_email_free(&p->email);
+    parse[num_parse++] = p;
+  }
+
+  int fds[MAILDIR_READAHEAD];
+  size_t ahead = 0;
+  for (size_t i = 0; i < num_parse; i++, count++)
+  {
+    if (!m->quiet && progress)
+      mutt_progress_update(progress, count, -1);
+
+    for (; (ahead < num_parse) && (ahead < (i + MAILDIR_READAHEAD)); ahead++)
+      fds[ahead % MAILDIR_READAHEAD] = maildir_open_ahead(m, parse[ahead]);
+
+    p = parse[i];
+    snprintf(fn, sizeof(fn), "%s/%s", mutt_b2s(m->pathbuf), p->email->path);
+
+    int fd = fds[i % MAILDIR_READAHEAD];
+    FILE *fp = (fd >= 0) ? fdopen(fd, "r") : NULL;
+    if (!fp)
+    {
+      if (fd >= 0)
+        close(fd);
+      mutt_email_free(&p->email);
+      continue;
+    }
+
+    maildir_parse_stream(m->magic, fp, fn, p->email->old, p->email);
+    mutt_file_fclose(&fp);
+    p->header_parsed = 1;
 #ifdef USE_HCACHE
+    if (m->magic == MUTT_MH)
+    {
+      key = p->email->path;
+      keylen = strlen(key);
     }
-    mutt_hcache_free(hc, &data);
+    else
+    {
+      key = p->email->path + 3;
+      keylen = maildir_hcache_keylen(key);
+    }
+    mutt_hcache_store(hc, key, keylen, p->email, 0);
 #endif
-    last = p;
   }
+
 #ifdef USE_HCACHE
   mutt_hcache_close(hc);
 #endif
+  FREE(&parse);
 
   mh_sort_natural(m, md);
 }
@@ -1410,6 +1403,12 @@ int mh_sync_mailbox_message(struct Mailbox *m, int msgno, header_cache_t *hc)
 
   struct Email *e = m->emails[msgno];
 
+#ifdef USE_HCACHE
+  /* Maildir flags live in the filename, which is parsed again when the Email
+   * is restored from the cache, so a rename doesn't need a store */
+  bool store = (m->magic != MUTT_MAILDIR) || e->attach_del || (e->env && e->env->changed);
+#endif
+
   if (e->deleted && ((m->magic != MUTT_MAILDIR) || !C_MaildirTrash))
   {
     char path[PATH_MAX];
@@ -1465,7 +1464,7 @@ int mh_sync_mailbox_message(struct Mailbox *m, int msgno, header_cache_t *hc)
   }
 
 #ifdef USE_HCACHE
-  if (hc && e->changed)
+  if (hc && e->changed && store)
   {
     const char *key = NULL;
     size_t keylen;
@@ -1718,6 +1717,33 @@ int maildir_path_parent(char *buf, size_t buflen)
   return -1;
 }
 
+/**
+ * mh_sync_dir - Flush a directory's entries to disk
+ * @param m       Mailbox
+ * @param subdir  Subdirectory, e.g. "cur", or NULL for the Mailbox's directory
+ *
+ * After renaming or deleting a batch of messages, a single fsync() of the
+ * directory makes all the changes durable.
+ */
+static void mh_sync_dir(struct Mailbox *m, const char *subdir)
+{
+  struct Buffer *path = mutt_buffer_pool_get();
+  if (subdir)
+    mutt_buffer_printf(path, "%s/%s", mutt_b2s(m->pathbuf), subdir);
+  else
+    mutt_buffer_strcpy(path, mutt_b2s(m->pathbuf));
+
+  int fd = open(mutt_b2s(path), O_RDONLY);
+  if (fd >= 0)
+  {
+    if (fsync(fd) != 0)
+      mutt_debug(LL_DEBUG1, "fsync %s: %s\n", mutt_b2s(path), strerror(errno));
+    close(fd);
+  }
+
+  mutt_buffer_pool_release(&path);
+}
+
 /**
  * mh_mbox_sync - Implements MxOps::mbox_sync()
  */
@@ -1759,6 +1785,14 @@ int mh_mbox_sync(struct Mailbox *m, int *index_hint)
       goto err;
   }
 
+  if (m->magic == MUTT_MAILDIR)
+  {
+    mh_sync_dir(m, "cur");
+    mh_sync_dir(m, "new");
+  }
+  else
+    mh_sync_dir(m, NULL);
+
 #ifdef USE_HCACHE
   if ((m->magic == MUTT_MAILDIR) || (m->magic == MUTT_MH))
     mutt_hcache_close(hc);
@@ -828,6 +828,9 @@ int main(int argc, char *argv[], char *envp[])
   cs_add_observer(Config, mutt_log_observer);
   cs_add_observer(Config, mutt_menu_observer);
   cs_add_observer(Config, mutt_reply_observer);
+#ifdef USE_SIDEBAR
+  cs_add_observer(Config, mutt_sb_observer);
+#endif
 
   if (sendflags & SEND_POSTPONED)
   {
@@ -1261,6 +1264,8 @@ main_exit:
   mutt_buffer_pool_free();
   mutt_envlist_free();
   mutt_browser_cleanup();
+  mutt_ch_cache_cleanup();
+  rfc2047_decode_cleanup();
   mutt_free_opts();
   mutt_free_keys();
   cs_free(&Config);
@@ -29,7 +29,6 @@
 #include "config.h"
 #include <errno.h>
 #include <limits.h>
-#include <poll.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -44,20 +43,18 @@
 #include "globals.h"
 #include "mailbox.h"
 #include "mutt_curses.h"
+#include "mutt_poll.h"
 #include "mx.h"
 
-int MonitorFilesChanged = 0;
 int MonitorContextChanged = 0;
 
 static int INotifyFd = -1;
 static struct Monitor *Monitor = NULL;
-static size_t PollFdsCount = 0;
-static size_t PollFdsLen = 0;
-static struct pollfd *PollFds = NULL;
 
 static int MonitorContextDescriptor = -1;
 
 #define INOTIFY_MASK_DIR (IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE | IN_ISDIR)
+#define INOTIFY_MASK_CUR (INOTIFY_MASK_DIR | IN_CREATE | IN_DELETE | IN_MOVED_FROM)
 #define INOTIFY_MASK_FILE IN_CLOSE_WRITE
 
 #define EVENT_BUFLEN MAX(4096, sizeof(struct inotify_event) + NAME_MAX + 1)
@@ -68,6 +65,22 @@ static int MonitorContextDescriptor = -1;
 #define RESOLVERES_OK_NOTEXISTING 0
 #define RESOLVERES_OK_EXISTING 1
 
+/**
+ * struct MonitorStats - Message counts of a Maildir's 'cur', kept up to date by inotify
+ *
+ * 'new' isn't counted.  Watching it for files leaving would wake NeoMutt
+ * every time it moves a message to 'cur' itself.
+ */
+struct MonitorStats
+{
+  bool valid;    ///< Counts have been seeded by a scan, and are still correct
+  bool scanning; ///< A scan is in progress, and nothing has happened yet
+  bool has_new;
+  int count;
+  int unread;
+  int flagged;
+};
+
 /**
  * struct Monitor - A watch on a file
  */
@@ -79,6 +92,8 @@ struct Monitor
   ino_t st_ino;
   enum MailboxType magic;
   int desc;
+  int desc_cur;             ///< Watch on a Maildir's 'cur' directory
+  struct MonitorStats stats; ///< Maildir only
 };
 
 /**
@@ -95,51 +110,7 @@ struct MonitorInfo
   struct Buffer *path_buf; /* access via path only (maybe not initialized) */
 };
 
-/**
- * mutt_poll_fd_add - Add a file to the watch list
- * @param fd     File to watch
- * @param events Events to listen for, e.g. POLLIN
- */
-static void mutt_poll_fd_add(int fd, short events)
-{
-  int i = 0;
-  for (; (i < PollFdsCount) && (PollFds[i].fd != fd); i++)
-    ;
-
-  if (i == PollFdsCount)
-  {
-    if (PollFdsCount == PollFdsLen)
-    {
-      PollFdsLen += 2;
-      mutt_mem_realloc(&PollFds, PollFdsLen * sizeof(struct pollfd));
-    }
-    PollFdsCount++;
-    PollFds[i].fd = fd;
-    PollFds[i].events = events;
-  }
-  else
-    PollFds[i].events |= events;
-}
-
-/**
- * mutt_poll_fd_remove - Remove a file from the watch list
- * @param fd File to remove
- * @retval  0 Success
- * @retval -1 Error
- */
-static int mutt_poll_fd_remove(int fd)
-{
-  int i = 0;
-  for (; (i < PollFdsCount) && (PollFds[i].fd != fd); i++)
-    ;
-  if (i == PollFdsCount)
-    return -1;
-  int d = PollFdsCount - i - 1;
-  if (d != 0)
-    memmove(&PollFds[i], &PollFds[i + 1], d * sizeof(struct pollfd));
-  PollFdsCount--;
-  return 0;
-}
+static void monitor_poll_handler(int fd, void *data);
 
 /**
  * monitor_init - Set up file monitoring
@@ -156,8 +127,7 @@ static int monitor_init(void)
       mutt_debug(LL_DEBUG2, "inotify_init1 failed, errno=%d %s\n", errno, strerror(errno));
       return -1;
     }
-    mutt_poll_fd_add(0, POLLIN);
-    mutt_poll_fd_add(INotifyFd, POLLIN);
+    mutt_poll_add(INotifyFd, monitor_poll_handler, NULL);
   }
   return 0;
 }
@@ -169,10 +139,9 @@ static void monitor_check_free(void)
 {
   if (!Monitor && (INotifyFd != -1))
   {
-    mutt_poll_fd_remove(INotifyFd);
+    mutt_poll_remove(INotifyFd);
     close(INotifyFd);
     INotifyFd = -1;
-    MonitorFilesChanged = 0;
   }
 }
 
@@ -189,6 +158,7 @@ static struct Monitor *monitor_new(struct MonitorInfo *info, int descriptor)
   monitor->st_dev = info->st_dev;
   monitor->st_ino = info->st_ino;
   monitor->desc = descriptor;
+  monitor->desc_cur = -1;
   monitor->next = Monitor;
   if (info->magic == MUTT_MH)
     monitor->mh_backup_path = mutt_str_strdup(info->path);
@@ -236,6 +206,9 @@ static void monitor_delete(struct Monitor *monitor)
     ptr = &(*ptr)->next;
   }
 
+  if (monitor->desc_cur != -1)
+    inotify_rm_watch(INotifyFd, monitor->desc_cur);
+
   FREE(&monitor->mh_backup_path);
   monitor = monitor->next;
   FREE(ptr);
@@ -254,9 +227,17 @@ static int monitor_handle_ignore(int desc)
   struct Monitor *iter = Monitor;
   struct stat sb;
 
-  while (iter && (iter->desc != desc))
+  while (iter && (iter->desc != desc) && (iter->desc_cur != desc))
     iter = iter->next;
 
+  if (iter && (iter->desc_cur == desc))
+  {
+    mutt_debug(LL_DEBUG3, "cleanup watch (implicitly removed) - descriptor=%d\n", desc);
+    iter->desc_cur = -1;
+    iter->stats.valid = false;
+    return -1;
+  }
+
   if (iter)
   {
     if ((iter->magic == MUTT_MH) && (stat(iter->mh_backup_path, &sb) == 0))
@@ -364,89 +345,135 @@ static int monitor_resolve(struct MonitorInfo *info, struct Mailbox *m)
 }
 
 /**
- * mutt_monitor_poll - Check for filesystem changes
- * @retval -3 unknown/unexpected events: poll timeout / fds not handled by us
- * @retval -2 monitor detected changes, no STDIN input
- * @retval -1 error (see errno)
- * @retval  0 (1) input ready from STDIN, or (2) monitoring inactive -> no poll()
- *
- * Wait for I/O ready file descriptors or signals.
- *
- * MonitorFilesChanged also reflects changes to monitored files.
+ * monitor_find - Find the monitor that owns a watch descriptor
+ * @param[in]  desc Watch descriptor
+ * @param[out] cur  Set to true if it's the watch on a Maildir's 'cur'
+ * @retval ptr Monitor
+ * @retval NULL Not found
+ */
+static struct Monitor *monitor_find(int desc, bool *cur)
+{
+  for (struct Monitor *iter = Monitor; iter; iter = iter->next)
+  {
+    if ((iter->desc == desc) || (iter->desc_cur == desc))
+    {
+      *cur = (iter->desc_cur == desc);
+      return iter;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * monitor_update_stats - Apply a file event to a Maildir's counts
+ * @param monitor Monitor of the Maildir
+ * @param event   inotify event in 'cur'
  *
- * Only STDIN and INotify file handles currently expected/supported.
- * More would ask for common infrastructure (sockets?).
+ * The flags are taken from the file's name, like maildir_check_dir() does.
+ * If a change might clear has_new, the counts are dropped, because only a
+ * rescan can tell.
  */
-int mutt_monitor_poll(void)
+static void monitor_update_stats(struct Monitor *monitor, const struct inotify_event *event)
 {
-  int rc = 0;
-  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+  struct MonitorStats *stats = &monitor->stats;
+  if (!stats->valid)
+  {
+    /* The scan may, or may not, have seen this change */
+    stats->scanning = false;
+    return;
+  }
+
+  if ((event->mask & IN_ISDIR) || (event->len == 0) || (event->name[0] == '.'))
+    return;
+
+  int delta;
+  if (event->mask & (IN_CREATE | IN_MOVED_TO))
+    delta = 1;
+  else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+    delta = -1;
+  else
+    return;
+
+  const char *p = strstr(event->name, ":2,");
+  if (p && strchr(p + 3, 'T'))
+    return;
 
-  MonitorFilesChanged = 0;
+  const bool unread = !p || !strchr(p + 3, 'S');
 
-  if (INotifyFd != -1)
+  if (delta < 0)
   {
-    int fds = poll(PollFds, PollFdsLen, MuttGetchTimeout);
+    if (stats->has_new)
+    {
+      stats->valid = false;
+      return;
+    }
+  }
+  else if (unread && C_MaildirCheckCur)
+  {
+    stats->has_new = true;
+  }
 
-    if (fds == -1)
+  stats->count += delta;
+  if (unread)
+    stats->unread += delta;
+  if (p && strchr(p + 3, 'F'))
+    stats->flagged += delta;
+}
+
+/**
+ * monitor_read_events - Read and handle all the pending inotify events
+ */
+static void monitor_read_events(void)
+{
+  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  while (true)
+  {
+    int len = read(INotifyFd, buf, sizeof(buf));
+    if (len == -1)
     {
-      rc = -1;
-      if (errno != EINTR)
-      {
-        mutt_debug(LL_DEBUG2, "poll() failed, errno=%d %s\n", errno, strerror(errno));
-      }
+      if (errno != EAGAIN)
+        mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n", errno,
+                   strerror(errno));
+      break;
     }
-    else
+
+    char *ptr = buf;
+    while (ptr < (buf + len))
     {
-      bool input_ready = false;
-      for (int i = 0; fds && (i < PollFdsCount); i++)
+      const struct inotify_event *event = (const struct inotify_event *) ptr;
+      mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n", event->wd, event->mask);
+      if (event->mask & IN_Q_OVERFLOW)
       {
-        if (PollFds[i].revents)
-        {
-          fds--;
-          if (PollFds[i].fd == 0)
-          {
-            input_ready = true;
-          }
-          else if (PollFds[i].fd == INotifyFd)
-          {
-            MonitorFilesChanged = 1;
-            mutt_debug(LL_DEBUG3, "file change(s) detected\n");
-            char *ptr = buf;
-            const struct inotify_event *event = NULL;
-
-            while (true)
-            {
-              int len = read(INotifyFd, buf, sizeof(buf));
-              if (len == -1)
-              {
-                if (errno != EAGAIN)
-                  mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n",
-                             errno, strerror(errno));
-                break;
-              }
-
-              while (ptr < (buf + len))
-              {
-                event = (const struct inotify_event *) ptr;
-                mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n",
-                           event->wd, event->mask);
-                if (event->mask & IN_IGNORED)
-                  monitor_handle_ignore(event->wd);
-                else if (event->wd == MonitorContextDescriptor)
-                  MonitorContextChanged = 1;
-                ptr += sizeof(struct inotify_event) + event->len;
-              }
-            }
-          }
-        }
+        /* Events have been lost, so the counts can't be trusted */
+        for (struct Monitor *iter = Monitor; iter; iter = iter->next)
+          iter->stats.valid = false;
       }
-      if (!input_ready)
-        rc = MonitorFilesChanged ? -2 : -3;
+      else if (event->mask & IN_IGNORED)
+        monitor_handle_ignore(event->wd);
+      else
+      {
+        if (event->wd == MonitorContextDescriptor)
+          MonitorContextChanged = 1;
+
+        bool cur = false;
+        struct Monitor *monitor = monitor_find(event->wd, &cur);
+        if (monitor && cur && (monitor->magic == MUTT_MAILDIR))
+          monitor_update_stats(monitor, event);
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
     }
   }
+}
 
-  return rc;
+/**
+ * monitor_poll_handler - Handle inotify events - Implements ::poll_handler_t
+ */
+static void monitor_poll_handler(int fd, void *data)
+{
+  mutt_debug(LL_DEBUG3, "file change(s) detected\n");
+  monitor_read_events();
 }
 
 /**
@@ -467,7 +494,11 @@ int mutt_monitor_add(struct Mailbox *m)
   if (desc != RESOLVERES_OK_NOTEXISTING)
   {
     if (!m && (desc == RESOLVERES_OK_EXISTING))
+    {
       MonitorContextDescriptor = info.monitor->desc;
+      /* Opening the mailbox changes what counts as new mail */
+      info.monitor->stats.valid = false;
+    }
     rc = (desc == RESOLVERES_OK_EXISTING) ? 0 : -1;
     goto cleanup;
   }
@@ -486,7 +517,19 @@ int mutt_monitor_add(struct Mailbox *m)
   if (!m)
     MonitorContextDescriptor = desc;
 
-  monitor_new(&info, desc);
+  struct Monitor *monitor = monitor_new(&info, desc);
+
+  /* Watch 'cur' too, to keep the message counts up to date */
+  if (info.magic == MUTT_MAILDIR)
+  {
+    mutt_buffer_printf(info.path_buf, "%s/cur", m ? m->realpath : Context->mailbox->realpath);
+    monitor->desc_cur = inotify_add_watch(INotifyFd, mutt_b2s(info.path_buf), INOTIFY_MASK_CUR);
+    if (monitor->desc_cur == -1)
+    {
+      mutt_debug(LL_DEBUG2, "inotify_add_watch failed for '%s', errno=%d %s\n",
+                 mutt_b2s(info.path_buf), errno, strerror(errno));
+    }
+  }
 
 cleanup:
   monitor_info_free(&info);
@@ -522,6 +565,9 @@ int mutt_monitor_remove(struct Mailbox *m)
     goto cleanup;
   }
 
+  if (!m)
+    info.monitor->stats.valid = false;
+
   if (Context)
   {
     if (m)
@@ -543,7 +589,7 @@ int mutt_monitor_remove(struct Mailbox *m)
     }
   }
 
-  inotify_rm_watch(info.monitor->desc, INotifyFd);
+  inotify_rm_watch(INotifyFd, info.monitor->desc);
   mutt_debug(LL_DEBUG3, "inotify_rm_watch for '%s' descriptor=%d\n", info.path,
              info.monitor->desc);
 
@@ -555,3 +601,81 @@ cleanup:
   monitor_info_free(&info2);
   return rc;
 }
+
+/**
+ * mutt_monitor_get_stats - Get the message counts of a Maildir's 'cur' from its monitor
+ * @param m Mailbox
+ * @retval  0 Success, the Mailbox's counts and has_new have been set
+ * @retval -1 The monitor has no counts, 'cur' must be scanned
+ */
+int mutt_monitor_get_stats(struct Mailbox *m)
+{
+  struct MonitorInfo info;
+  monitor_info_init(&info);
+
+  int rc = -1;
+  if ((INotifyFd == -1) || (m->magic != MUTT_MAILDIR))
+    goto cleanup;
+
+  /* Apply the events that haven't been polled for, yet */
+  monitor_read_events();
+
+  if (monitor_resolve(&info, m) != RESOLVERES_OK_EXISTING)
+    goto cleanup;
+
+  struct MonitorStats *stats = &info.monitor->stats;
+  if (!stats->valid || (info.monitor->desc_cur == -1))
+  {
+    /* The caller will scan 'cur' */
+    stats->valid = false;
+    stats->scanning = true;
+    goto cleanup;
+  }
+
+  m->msg_count = stats->count;
+  m->msg_unread = stats->unread;
+  m->msg_flagged = stats->flagged;
+  m->msg_new = 0;
+  if (stats->has_new)
+    m->has_new = true;
+  rc = 0;
+
+cleanup:
+  monitor_info_free(&info);
+  return rc;
+}
+
+/**
+ * mutt_monitor_set_stats - Seed a Maildir's monitor with its message counts
+ * @param m Mailbox whose 'cur' has just been scanned, on its own
+ *
+ * From now on, the counts are kept up to date from the file events.  If
+ * anything happened during the scan, the counts aren't trusted.
+ */
+void mutt_monitor_set_stats(struct Mailbox *m)
+{
+  struct MonitorInfo info;
+  monitor_info_init(&info);
+
+  if ((INotifyFd == -1) || (m->magic != MUTT_MAILDIR))
+    goto cleanup;
+
+  monitor_read_events();
+
+  if (monitor_resolve(&info, m) != RESOLVERES_OK_EXISTING)
+    goto cleanup;
+
+  struct MonitorStats *stats = &info.monitor->stats;
+  if (stats->scanning && (info.monitor->desc_cur != -1))
+  {
+    stats->count = m->msg_count;
+    stats->unread = m->msg_unread;
+    stats->flagged = m->msg_flagged;
+    stats->has_new = m->has_new;
+    stats->valid = true;
+  }
+  stats->scanning = false;
+
+cleanup:
+  monitor_info_free(&info);
+}
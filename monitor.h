@@ -23,13 +23,13 @@
 #ifndef MUTT_MONITOR_H
 #define MUTT_MONITOR_H
 
-extern int MonitorFilesChanged;   ///< true after a monitored file has changed
 extern int MonitorContextChanged; ///< true after the current mailbox has changed
 
 struct Mailbox;
 
 int mutt_monitor_add(struct Mailbox *m);
 int mutt_monitor_remove(struct Mailbox *m);
-int mutt_monitor_poll(void);
+int mutt_monitor_get_stats(struct Mailbox *m);
+void mutt_monitor_set_stats(struct Mailbox *m);
 
 #endif /* MUTT_MONITOR_H */
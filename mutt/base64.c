@@ -181,6 +181,77 @@ int mutt_b64_decode(const char *in, char *out, size_t olen)
   return len;
 }
 
+/**
+ * mutt_b64_decode_stream - Decode a block of a base64 stream
+ * @param dec   Progress of the decode, zeroed before the first block
+ * @param in    Block of base64 text
+ * @param inlen Length of the block
+ * @param out   Output buffer for the raw bytes
+ * @retval num Bytes written to the output buffer
+ *
+ * Characters that aren't part of the base64 alphabet, e.g. line breaks, are
+ * skipped.  A group of four characters may be split across blocks.  Once
+ * padding has been seen, the rest of the stream is ignored.
+ *
+ * The output buffer needs room for ((inlen + 3) / 4) * 3 bytes.
+ */
+size_t mutt_b64_decode_stream(struct B64Decoder *dec, const char *in, size_t inlen, char *out)
+{
+  if (!dec || !in || !out)
+    return 0;
+
+  char *begin = out;
+  const unsigned char *inu = (const unsigned char *) in;
+  const unsigned char *end = inu + inlen;
+
+  while (!dec->done && (inu < end))
+  {
+    /* Fast path: four base64 digits in a row */
+    if ((dec->num == 0) && ((end - inu) >= 4) && !((inu[0] | inu[1] | inu[2] | inu[3]) & 0x80))
+    {
+      const int c1 = base64val(inu[0]);
+      const int c2 = base64val(inu[1]);
+      const int c3 = base64val(inu[2]);
+      const int c4 = base64val(inu[3]);
+      if ((c1 | c2 | c3 | c4) >= 0)
+      {
+        *out++ = (c1 << 2) | (c2 >> 4);
+        *out++ = ((c2 & 0xf) << 4) | (c3 >> 2);
+        *out++ = ((c3 & 0x3) << 6) | c4;
+        inu += 4;
+        continue;
+      }
+    }
+
+    const unsigned char ch = *inu++;
+    if ((ch > 127) || ((base64val(ch) == BAD) && (ch != '=')))
+      continue;
+
+    dec->pending[dec->num++] = ch;
+    if (dec->num < 4)
+      continue;
+    dec->num = 0;
+
+    const int c1 = base64val(dec->pending[0]);
+    const int c2 = base64val(dec->pending[1]);
+    *out++ = (c1 << 2) | (c2 >> 4);
+
+    dec->done = (dec->pending[2] == '=');
+    if (dec->done)
+      break;
+    const int c3 = base64val(dec->pending[2]);
+    *out++ = ((c2 & 0xf) << 4) | (c3 >> 2);
+
+    dec->done = (dec->pending[3] == '=');
+    if (dec->done)
+      break;
+    const int c4 = base64val(dec->pending[3]);
+    *out++ = ((c3 & 0x3) << 6) | c4;
+  }
+
+  return out - begin;
+}
+
 /**
  * mutt_b64_buffer_encode - Convert raw bytes to null-terminated base64 string
  * @param buf    Buffer for the result
@@ -21,15 +21,27 @@
 #ifndef MUTT_LIB_BASE64_H
 #define MUTT_LIB_BASE64_H
 
+#include <stdbool.h>
 #include <stdio.h>
 
 struct Buffer;
 
+/**
+ * struct B64Decoder - Progress of a streaming base64 decode
+ */
+struct B64Decoder
+{
+  char pending[4]; ///< Characters of an incomplete group of four
+  int num;         ///< Number of characters in pending
+  bool done;       ///< Padding has been seen, ignore the rest of the input
+};
+
 extern const int Index64[];
 
 #define base64val(ch) Index64[(unsigned int) (ch)]
 
 int    mutt_b64_decode(const char *in, char *out, size_t olen);
+size_t mutt_b64_decode_stream(struct B64Decoder *dec, const char *in, size_t inlen, char *out);
 size_t mutt_b64_encode(const char *in, size_t inlen, char *out, size_t outlen);
 
 int    mutt_b64_buffer_decode(struct Buffer *buf, const char *in);
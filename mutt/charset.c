@@ -77,6 +77,27 @@ struct Lookup
 };
 static TAILQ_HEAD(, Lookup) Lookups = TAILQ_HEAD_INITIALIZER(Lookups);
 
+#define ICONV_CACHE_SIZE 16 ///< Number of iconv descriptors to keep open
+
+/**
+ * struct IconvCacheEntry - A cached iconv descriptor
+ *
+ * The entry is keyed on the names passed to mutt_ch_iconv_open(), so a hit
+ * skips the charset lookups, too.
+ */
+struct IconvCacheEntry
+{
+  char *tocode;   /**< Target character set, as requested */
+  char *fromcode; /**< Source character set, as requested */
+  int flags;      /**< Flags, e.g. #MUTT_ICONV_HOOK_FROM */
+  iconv_t cd;     /**< iconv descriptor, or -1 if it couldn't be opened */
+  bool busy;      /**< Descriptor is in use, until mutt_ch_iconv_close() */
+};
+
+/** Recently used iconv descriptors, most recent first */
+static struct IconvCacheEntry IconvCache[ICONV_CACHE_SIZE];
+static int IconvCacheUsed = 0;
+
 // clang-format off
 /**
  * PreferredMimeNames - Lookup table of preferred charsets
@@ -469,6 +490,7 @@ bool mutt_ch_lookup_add(enum LookupType type, const char *pat,
   l->regex.not = false;
 
   TAILQ_INSERT_TAIL(&Lookups, l, entries);
+  mutt_ch_cache_cleanup();
 
   return true;
 }
@@ -494,6 +516,7 @@ void mutt_ch_lookup_remove(void)
     FREE(&l->regex);
     FREE(&l);
   }
+  mutt_ch_cache_cleanup();
 }
 
 /**
@@ -511,28 +534,74 @@ const char *mutt_ch_charset_lookup(const char *chs)
 }
 
 /**
- * mutt_ch_iconv_open - Set up iconv for conversions
+ * iconv_cache_evict - Remove an entry from the iconv cache
+ * @param idx Index of the entry
+ *
+ * If the descriptor is still in use, mutt_ch_iconv_close() will close it.
+ */
+static void iconv_cache_evict(int idx)
+{
+  struct IconvCacheEntry *ice = &IconvCache[idx];
+
+  if (!ice->busy && (ice->cd != (iconv_t) -1))
+    iconv_close(ice->cd);
+  FREE(&ice->tocode);
+  FREE(&ice->fromcode);
+
+  IconvCacheUsed--;
+  memmove(ice, ice + 1, (IconvCacheUsed - idx) * sizeof(*ice));
+}
+
+/**
+ * iconv_cache_add - Add a descriptor to the front of the iconv cache
+ * @param tocode   Target character set
+ * @param fromcode Source character set
+ * @param flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
+ * @param cd       iconv descriptor, or -1
+ */
+static void iconv_cache_add(const char *tocode, const char *fromcode, int flags, iconv_t cd)
+{
+  if (IconvCacheUsed == ICONV_CACHE_SIZE)
+  {
+    /* Drop the least recently used idle entry */
+    int i;
+    for (i = IconvCacheUsed - 1; (i >= 0) && IconvCache[i].busy; i--)
+      ;
+    if (i < 0)
+      return;
+    iconv_cache_evict(i);
+  }
+
+  memmove(&IconvCache[1], &IconvCache[0], IconvCacheUsed * sizeof(IconvCache[0]));
+  IconvCacheUsed++;
+
+  struct IconvCacheEntry *ice = &IconvCache[0];
+  ice->tocode = mutt_str_strdup(tocode);
+  ice->fromcode = mutt_str_strdup(fromcode);
+  ice->flags = flags;
+  ice->cd = cd;
+  ice->busy = (cd != (iconv_t) -1);
+}
+
+/**
+ * mutt_ch_cache_cleanup - Close the cached iconv descriptors
+ *
+ * Descriptors that are still in use are closed by mutt_ch_iconv_close().
+ */
+void mutt_ch_cache_cleanup(void)
+{
+  while (IconvCacheUsed > 0)
+    iconv_cache_evict(IconvCacheUsed - 1);
+}
+
+/**
+ * iconv_open_lookup - Set up iconv for conversions, applying the hooks
  * @param tocode   Current character set
  * @param fromcode Target character set
  * @param flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
  * @retval ptr iconv handle for the conversion
- *
- * Like iconv_open, but canonicalises the charsets, applies charset-hooks,
- * recanonicalises, and finally applies iconv-hooks. Parameter flags=0 skips
- * charset-hooks, while MUTT_ICONV_HOOK_FROM applies them to fromcode. Callers
- * should use flags=0 when fromcode can safely be considered true, either some
- * constant, or some value provided by the user; MUTT_ICONV_HOOK_FROM should be
- * used only when fromcode is unsure, taken from a possibly wrong incoming MIME
- * label, or such. Misusing MUTT_ICONV_HOOK_FROM leads to unwanted interactions
- * in some setups.
- *
- * @note By design charset-hooks should never be, and are never, applied
- * to tocode.
- *
- * @note The top-well-named MUTT_ICONV_HOOK_FROM acts on charset-hooks,
- * not at all on iconv-hooks.
  */
-iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, int flags)
+static iconv_t iconv_open_lookup(const char *tocode, const char *fromcode, int flags)
 {
   char tocode1[128];
   char fromcode1[128];
@@ -569,6 +638,93 @@ iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, int flags)
   return (iconv_t) -1;
 }
 
+/**
+ * mutt_ch_iconv_open - Set up iconv for conversions
+ * @param tocode   Current character set
+ * @param fromcode Target character set
+ * @param flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
+ * @retval ptr iconv handle for the conversion
+ *
+ * Like iconv_open, but canonicalises the charsets, applies charset-hooks,
+ * recanonicalises, and finally applies iconv-hooks. Parameter flags=0 skips
+ * charset-hooks, while MUTT_ICONV_HOOK_FROM applies them to fromcode. Callers
+ * should use flags=0 when fromcode can safely be considered true, either some
+ * constant, or some value provided by the user; MUTT_ICONV_HOOK_FROM should be
+ * used only when fromcode is unsure, taken from a possibly wrong incoming MIME
+ * label, or such. Misusing MUTT_ICONV_HOOK_FROM leads to unwanted interactions
+ * in some setups.
+ *
+ * Recently used descriptors are kept open and reset before they're reused.
+ * The handle must be released with mutt_ch_iconv_close(), not iconv_close().
+ *
+ * @note By design charset-hooks should never be, and are never, applied
+ * to tocode.
+ *
+ * @note The top-well-named MUTT_ICONV_HOOK_FROM acts on charset-hooks,
+ * not at all on iconv-hooks.
+ */
+iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, int flags)
+{
+  bool found = false;
+
+  for (int i = 0; i < IconvCacheUsed; i++)
+  {
+    struct IconvCacheEntry *ice = &IconvCache[i];
+    if ((ice->flags != flags) || (mutt_str_strcmp(ice->tocode, tocode) != 0) ||
+        (mutt_str_strcmp(ice->fromcode, fromcode) != 0))
+    {
+      continue;
+    }
+
+    found = true;
+    if (ice->busy)
+      continue;
+
+    /* Move it to the front */
+    struct IconvCacheEntry hit = *ice;
+    memmove(&IconvCache[1], &IconvCache[0], i * sizeof(IconvCache[0]));
+    IconvCache[0] = hit;
+
+    if (hit.cd != (iconv_t) -1)
+    {
+      iconv(hit.cd, NULL, NULL, NULL, NULL); /* Reset the conversion state */
+      IconvCache[0].busy = true;
+    }
+    return hit.cd;
+  }
+
+  iconv_t cd = iconv_open_lookup(tocode, fromcode, flags);
+
+  /* Only cache one failure per key */
+  if (!found || (cd != (iconv_t) -1))
+    iconv_cache_add(tocode, fromcode, flags, cd);
+
+  return cd;
+}
+
+/**
+ * mutt_ch_iconv_close - Release an iconv handle
+ * @param cd iconv handle from mutt_ch_iconv_open()
+ *
+ * The handle is returned to the cache, or closed if it isn't cached.
+ */
+void mutt_ch_iconv_close(iconv_t cd)
+{
+  if (cd == (iconv_t) -1)
+    return;
+
+  for (int i = 0; i < IconvCacheUsed; i++)
+  {
+    if (IconvCache[i].cd == cd)
+    {
+      IconvCache[i].busy = false;
+      return;
+    }
+  }
+
+  iconv_close(cd);
+}
+
 /**
  * mutt_ch_iconv - Change the encoding of a string
  * @param[in]     cd           Iconv conversion descriptor
@@ -704,7 +860,7 @@ int mutt_ch_check(const char *s, size_t slen, const char *from, const char *to)
     rc = errno;
 
   FREE(&saved_out);
-  iconv_close(cd);
+  mutt_ch_iconv_close(cd);
   return rc;
 }
 
@@ -763,7 +919,7 @@ int mutt_ch_convert_string(char **ps, const char *from, const char *to, int flag
   ob = buf;
 
   mutt_ch_iconv(cd, &ib, &ibl, &ob, &obl, inrepls, outrepl, &rc);
-  iconv_close(cd);
+  mutt_ch_iconv_close(cd);
 
   *ob = '\0';
 
@@ -808,13 +964,192 @@ bool mutt_ch_check_charset(const char *cs, bool strict)
   iconv_t cd = mutt_ch_iconv_open(cs, cs, 0);
   if (cd != (iconv_t)(-1))
   {
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
     return true;
   }
 
   return false;
 }
 
+/**
+ * is_ascii_superset - Is a character set a stateless superset of ASCII?
+ * @param cs Character set, canonicalised
+ * @retval true Bytes below 0x80 always mean the same as in ASCII
+ */
+static bool is_ascii_superset(const char *cs)
+{
+  static const char *const prefixes[] = {
+    "us-ascii", "utf-8", "iso-8859-", "windows-125", "koi8-", NULL,
+  };
+
+  for (int i = 0; prefixes[i]; i++)
+    if (mutt_str_startswith(cs, prefixes[i], CASE_IGNORE))
+      return true;
+
+  return false;
+}
+
+/**
+ * utf8_valid_len - Measure the valid UTF-8 at the start of a buffer
+ * @param s   Buffer to check
+ * @param len Length of the buffer
+ * @retval num Length of the longest prefix of complete, valid characters
+ */
+static size_t utf8_valid_len(const unsigned char *s, size_t len)
+{
+  size_t i = 0;
+
+  while (i < len)
+  {
+    const unsigned char c = s[i];
+    unsigned char lo = 0x80, hi = 0xbf;
+    size_t n;
+
+    if (c < 0x80)
+    {
+      i++;
+      continue;
+    }
+
+    if ((c >= 0xc2) && (c <= 0xdf))
+      n = 1;
+    else if ((c >= 0xe0) && (c <= 0xef))
+    {
+      n = 2;
+      if (c == 0xe0)
+        lo = 0xa0; /* overlong */
+      else if (c == 0xed)
+        hi = 0x9f; /* surrogates */
+    }
+    else if ((c >= 0xf0) && (c <= 0xf4))
+    {
+      n = 3;
+      if (c == 0xf0)
+        lo = 0x90; /* overlong */
+      else if (c == 0xf4)
+        hi = 0x8f; /* beyond U+10FFFF */
+    }
+    else
+      break;
+
+    if (((i + n) >= len) || (s[i + 1] < lo) || (s[i + 1] > hi))
+      break;
+    if ((n > 1) && ((s[i + 2] & 0xc0) != 0x80))
+      break;
+    if ((n > 2) && ((s[i + 3] & 0xc0) != 0x80))
+      break;
+    i += n + 1;
+  }
+
+  return i;
+}
+
+/**
+ * fgetconv_convert - Convert as much of the input buffer as will fit
+ * @param fc FgetConv handle
+ *
+ * Runs of input that are the same in both charsets, e.g. plain ASCII, are
+ * copied as-is.  iconv is only given the input in between.
+ */
+static void fgetconv_convert(struct FgetConv *fc)
+{
+  size_t obl = sizeof(fc->bufo) - (fc->ob - fc->bufo);
+
+  if (!fc->copy_ascii && !fc->copy_utf8)
+  {
+    mutt_ch_iconv(fc->cd, (const char **) &fc->ib, &fc->ibl, &fc->ob, &obl,
+                  fc->inrepls, 0, NULL);
+    return;
+  }
+
+  while (fc->ibl && obl)
+  {
+    const unsigned char *ib = (const unsigned char *) fc->ib;
+    size_t n;
+
+    if (fc->copy_utf8)
+      n = utf8_valid_len(ib, fc->ibl);
+    else
+      for (n = 0; (n < fc->ibl) && (ib[n] < 0x80); n++)
+        ;
+
+    if (n != 0)
+    {
+      if (n > obl)
+      {
+        /* Don't split a character */
+        n = fc->copy_utf8 ? utf8_valid_len(ib, obl) : obl;
+        if (n == 0)
+          break;
+      }
+      memcpy(fc->ob, fc->ib, n);
+      fc->ob += n;
+      fc->ib += n;
+      fc->ibl -= n;
+      obl -= n;
+      continue;
+    }
+
+    /* Include the first ASCII character, so that iconv can tell
+     * a truncated sequence from one that continues in the next read. */
+    for (n = 0; (n < fc->ibl) && (ib[n] >= 0x80); n++)
+      ;
+    size_t ibl = MIN(n + 1, fc->ibl);
+    const size_t rest = fc->ibl - ibl;
+    mutt_ch_iconv(fc->cd, (const char **) &fc->ib, &ibl, &fc->ob, &obl,
+                  fc->inrepls, 0, NULL);
+    fc->ibl = ibl + rest;
+    if (ibl != 0) /* Incomplete input, or no room for the output */
+      break;
+  }
+}
+
+/**
+ * fgetconv_fill - Refill the output buffer
+ * @param fc FgetConv handle
+ * @retval true  There is converted output to return
+ * @retval false End of file, or unconvertible input
+ */
+static bool fgetconv_fill(struct FgetConv *fc)
+{
+  /* Try to convert some more */
+  fc->p = fc->bufo;
+  fc->ob = fc->bufo;
+  if (fc->ibl)
+  {
+    fgetconv_convert(fc);
+    if (fc->p < fc->ob)
+      return true;
+  }
+
+  /* If we trusted iconv a bit more, we would at this point
+   * ask why it had stopped converting ... */
+
+  /* Try to read some more */
+  if ((fc->ibl == sizeof(fc->bufi)) ||
+      (fc->ibl && (fc->ib + fc->ibl < fc->bufi + sizeof(fc->bufi))))
+  {
+    fc->p = 0;
+    return false;
+  }
+  if (fc->ibl)
+    memmove(fc->bufi, fc->ib, fc->ibl);
+  fc->ib = fc->bufi;
+  fc->ibl += fread(fc->ib + fc->ibl, 1, sizeof(fc->bufi) - fc->ibl, fc->fp);
+
+  /* Try harder this time to convert some */
+  if (fc->ibl)
+  {
+    fgetconv_convert(fc);
+    if (fc->p < fc->ob)
+      return true;
+  }
+
+  /* Either the file has finished or one of the buffers is too small */
+  fc->p = 0;
+  return false;
+}
+
 /**
  * mutt_ch_fgetconv_open - Prepare a file for charset conversion
  * @param fp    FILE ptr to prepare
@@ -843,6 +1178,20 @@ struct FgetConv *mutt_ch_fgetconv_open(FILE *fp, const char *from, const char *t
     fc->ib = fc->bufi;
     fc->ibl = 0;
     fc->inrepls = mutt_ch_is_utf8(to) ? repls : repls + 1;
+
+    /* Resolve the charsets the way mutt_ch_iconv_open() does */
+    char fromcode[128];
+    char tocode[128];
+    mutt_ch_canonical_charset(tocode, sizeof(tocode), to);
+    mutt_ch_canonical_charset(fromcode, sizeof(fromcode), from);
+    if (flags & MUTT_ICONV_HOOK_FROM)
+    {
+      const char *tmp = mutt_ch_charset_lookup(fromcode);
+      if (tmp)
+        mutt_ch_canonical_charset(fromcode, sizeof(fromcode), tmp);
+    }
+    fc->copy_ascii = is_ascii_superset(fromcode) && is_ascii_superset(tocode);
+    fc->copy_utf8 = mutt_ch_is_utf8(fromcode) && mutt_ch_is_utf8(tocode);
   }
   else
     fc = mutt_mem_malloc(sizeof(struct FgetConvNot));
@@ -861,7 +1210,7 @@ void mutt_ch_fgetconv_close(struct FgetConv **fc)
     return;
 
   if ((*fc)->cd != (iconv_t) -1)
-    iconv_close((*fc)->cd);
+    mutt_ch_iconv_close((*fc)->cd);
   FREE(fc);
 }
 
@@ -883,48 +1232,41 @@ int mutt_ch_fgetconv(struct FgetConv *fc)
     return fgetc(fc->fp);
   if (!fc->p)
     return EOF;
-  if (fc->p < fc->ob)
+  if ((fc->p < fc->ob) || fgetconv_fill(fc))
     return (unsigned char) *(fc->p)++;
 
-  /* Try to convert some more */
-  fc->p = fc->bufo;
-  fc->ob = fc->bufo;
-  if (fc->ibl)
-  {
-    size_t obl = sizeof(fc->bufo);
-    iconv(fc->cd, (ICONV_CONST char **) &fc->ib, &fc->ibl, &fc->ob, &obl);
-    if (fc->p < fc->ob)
-      return (unsigned char) *(fc->p)++;
-  }
+  return EOF;
+}
 
-  /* If we trusted iconv a bit more, we would at this point
-   * ask why it had stopped converting ... */
+/**
+ * mutt_ch_fgetconv_read - Read a block of a file, converting its character set
+ * @param fc     FgetConv handle
+ * @param buf    Buffer for the result
+ * @param buflen Length of the buffer
+ * @retval num Number of bytes read, 0 at the end of the file
+ *
+ * This is the block equivalent of mutt_ch_fgetconv().  The two may be mixed.
+ */
+size_t mutt_ch_fgetconv_read(struct FgetConv *fc, char *buf, size_t buflen)
+{
+  if (!fc || !buf)
+    return 0;
+  if (fc->cd == (iconv_t) -1)
+    return fread(buf, 1, buflen, fc->fp);
 
-  /* Try to read some more */
-  if ((fc->ibl == sizeof(fc->bufi)) ||
-      (fc->ibl && (fc->ib + fc->ibl < fc->bufi + sizeof(fc->bufi))))
+  size_t len = 0;
+  while (len < buflen)
   {
-    fc->p = 0;
-    return EOF;
-  }
-  if (fc->ibl)
-    memcpy(fc->bufi, fc->ib, fc->ibl);
-  fc->ib = fc->bufi;
-  fc->ibl += fread(fc->ib + fc->ibl, 1, sizeof(fc->bufi) - fc->ibl, fc->fp);
+    if (!fc->p || ((fc->p >= fc->ob) && !fgetconv_fill(fc)))
+      break;
 
-  /* Try harder this time to convert some */
-  if (fc->ibl)
-  {
-    size_t obl = sizeof(fc->bufo);
-    mutt_ch_iconv(fc->cd, (const char **) &fc->ib, &fc->ibl, &fc->ob, &obl,
-                  fc->inrepls, 0, NULL);
-    if (fc->p < fc->ob)
-      return (unsigned char) *(fc->p)++;
+    const size_t n = MIN((size_t)(fc->ob - fc->p), buflen - len);
+    memcpy(buf + len, fc->p, n);
+    fc->p += n;
+    len += n;
   }
 
-  /* Either the file has finished or one of the buffers is too small */
-  fc->p = 0;
-  return EOF;
+  return len;
 }
 
 /**
@@ -942,14 +1284,29 @@ char *mutt_ch_fgetconvs(char *buf, size_t buflen, struct FgetConv *fc)
   if (!buf)
     return NULL;
 
-  size_t r;
-  for (r = 0; (r + 1) < buflen;)
+  if (fc && (fc->cd == (iconv_t) -1))
   {
-    const int c = mutt_ch_fgetconv(fc);
-    if (c == EOF)
+    if ((buflen > 1) && fgets(buf, buflen, fc->fp))
+      return buf;
+    if (buflen > 0)
+      buf[0] = '\0';
+    return NULL;
+  }
+
+  size_t r = 0;
+  while ((r + 1) < buflen)
+  {
+    if (!fc || !fc->p || ((fc->p >= fc->ob) && !fgetconv_fill(fc)))
       break;
-    buf[r++] = (char) c;
-    if (c == '\n')
+
+    size_t n = MIN((size_t)(fc->ob - fc->p), buflen - 1 - r);
+    const char *nl = memchr(fc->p, '\n', n);
+    if (nl)
+      n = nl - fc->p + 1;
+    memcpy(buf + r, fc->p, n);
+    fc->p += n;
+    r += n;
+    if (nl)
       break;
   }
   buf[r] = '\0';
@@ -42,13 +42,15 @@ struct FgetConv
 {
   FILE *fp;
   iconv_t cd;
-  char bufi[512];
-  char bufo[512];
+  char bufi[4096];
+  char bufo[4096];
   char *p;
   char *ob;
   char *ib;
   size_t ibl;
   const char **inrepls;
+  bool copy_ascii; ///< ASCII is the same in both charsets, copy it unconverted
+  bool copy_utf8;  ///< Both charsets are UTF-8, copy valid input unconverted
 };
 
 /**
@@ -82,6 +84,7 @@ enum LookupType
 
 extern const struct MimeNames PreferredMimeNames[];
 
+void             mutt_ch_cache_cleanup(void);
 void             mutt_ch_canonical_charset(char *buf, size_t buflen, const char *name);
 const char *     mutt_ch_charset_lookup(const char *chs);
 int              mutt_ch_check(const char *s, size_t slen, const char *from, const char *to);
@@ -93,9 +96,11 @@ int              mutt_ch_convert_string(char **ps, const char *from, const char
 int              mutt_ch_fgetconv(struct FgetConv *fc);
 void             mutt_ch_fgetconv_close(struct FgetConv **fc);
 struct FgetConv *mutt_ch_fgetconv_open(FILE *fp, const char *from, const char *to, int flags);
+size_t           mutt_ch_fgetconv_read(struct FgetConv *fc, char *buf, size_t buflen);
 char *           mutt_ch_fgetconvs(char *buf, size_t buflen, struct FgetConv *fc);
 char *           mutt_ch_get_default_charset(void);
 char *           mutt_ch_get_langinfo_charset(void);
+void             mutt_ch_iconv_close(iconv_t cd);
 size_t           mutt_ch_iconv(iconv_t cd, const char **inbuf, size_t *inbytesleft, char **outbuf, size_t *outbytesleft, const char **inrepls, const char *outrepl, int *iconverrno);
 const char *     mutt_ch_iconv_lookup(const char *chs);
 iconv_t          mutt_ch_iconv_open(const char *tocode, const char *fromcode, int flags);
@@ -119,6 +119,198 @@ void mutt_regex_free(struct Regex **r)
   FREE(r);
 }
 
+/**
+ * literal_flush - Keep the longer of two literal strings
+ * @param run     Literal being built
+ * @param run_len Length of run; reset to 0
+ * @param buf     Longest literal so far
+ * @param buf_len Length of buf
+ */
+static void literal_flush(const char *run, size_t *run_len, char *buf, size_t *buf_len)
+{
+  if (*run_len > *buf_len)
+  {
+    memcpy(buf, run, *run_len);
+    *buf_len = *run_len;
+  }
+  *run_len = 0;
+}
+
+/**
+ * literal_skip - Skip over a bracket expression or a group in a regex
+ * @param p Start of the bracket expression '[' or group '('
+ * @retval ptr Character following the expression
+ */
+static const char *literal_skip(const char *p)
+{
+  if (*p == '[')
+  {
+    p++;
+    if (*p == '^')
+      p++;
+    if (*p == ']')
+      p++;
+    for (; *p && (*p != ']'); p++)
+    {
+      if ((p[0] == '[') && ((p[1] == ':') || (p[1] == '.') || (p[1] == '=')))
+      {
+        const char *end = strchr(p + 2, p[1]);
+        if (!end)
+          return p + strlen(p);
+        p = end + 1; /* skip the class, e.g. [:alpha:] */
+      }
+    }
+    return *p ? p + 1 : p;
+  }
+
+  int depth = 0;
+  while (*p)
+  {
+    if ((*p == '\\') && p[1])
+      p += 2;
+    else if (*p == '[')
+      p = literal_skip(p);
+    else if (*p == '(')
+    {
+      depth++;
+      p++;
+    }
+    else if (*p == ')')
+    {
+      p++;
+      if (--depth == 0)
+        break;
+    }
+    else
+      p++;
+  }
+  return p;
+}
+
+/**
+ * mutt_regex_literal - Find some text that every match of a regex must contain
+ * @param str    Regular expression (POSIX extended)
+ * @param flags  Flags, e.g. REG_ICASE
+ * @param buf    Buffer for the text
+ * @param buflen Length of the buffer
+ * @retval num Length of the text, 0 if there isn't any
+ *
+ * The text is the longest run of plain characters at the top level of the
+ * regex.  It's used to quickly rule out strings that can't match, so it errs
+ * on the side of returning less: a regex containing a top-level alternation
+ * has no text; only ASCII characters are used; and for a case-insensitive
+ * regex, letters that can match non-ASCII characters ('i', 'k' and 's') are
+ * also avoided.
+ *
+ * @note The text is not NUL-terminated
+ */
+size_t mutt_regex_literal(const char *str, int flags, char *buf, size_t buflen)
+{
+  if (!str || !buf || (buflen == 0))
+    return 0;
+
+  char *run = mutt_mem_malloc(buflen);
+  size_t run_len = 0;
+  size_t len = 0;
+
+  bool repeat = false; /* The last character of run is followed by '+' */
+
+  const char *p = str;
+  while (*p)
+  {
+    unsigned char c = *p;
+
+    /* The repeated character might still be made optional, e.g. a+? */
+    if (repeat && !strchr("*?{", c))
+    {
+      repeat = false;
+      if (c == '+')
+      {
+        repeat = true;
+        p++;
+        continue;
+      }
+      literal_flush(run, &run_len, buf, &len);
+    }
+    repeat = false;
+
+    if (c == '\\')
+    {
+      c = p[1];
+      if (c == '\0')
+        break;
+      if (c == '|')
+      {
+        len = 0;
+        goto done;
+      }
+      p += 2;
+      if (!strchr("\\.[]()*+?{}^$", c))
+      {
+        /* Backreference, or a GNU extension, e.g. \w, \< */
+        literal_flush(run, &run_len, buf, &len);
+        continue;
+      }
+    }
+    else if ((c == '[') || (c == '('))
+    {
+      p = literal_skip(p);
+      literal_flush(run, &run_len, buf, &len);
+      continue;
+    }
+    else if (c == '|')
+    {
+      len = 0;
+      goto done;
+    }
+    else if ((c == '*') || (c == '?') || (c == '{'))
+    {
+      /* The previous character is optional */
+      if (run_len > 0)
+        run_len--;
+      literal_flush(run, &run_len, buf, &len);
+      if (c == '{')
+      {
+        const char *end = strchr(p, '}');
+        p = end ? end : p + strlen(p) - 1;
+      }
+      p++;
+      continue;
+    }
+    else if (c == '+')
+    {
+      repeat = true;
+      p++;
+      continue;
+    }
+    else if ((c == '.') || (c == '^') || (c == '$') || (c == ')'))
+    {
+      literal_flush(run, &run_len, buf, &len);
+      p++;
+      continue;
+    }
+    else
+    {
+      p++;
+    }
+
+    if ((c & 0x80) || ((flags & REG_ICASE) && strchr("iIkKsS", c)))
+    {
+      literal_flush(run, &run_len, buf, &len);
+      continue;
+    }
+
+    if (run_len == buflen)
+      literal_flush(run, &run_len, buf, &len);
+    run[run_len++] = c;
+  }
+  literal_flush(run, &run_len, buf, &len);
+
+done:
+  FREE(&run);
+  return len;
+}
+
 /**
  * mutt_regexlist_add - Compile a regex string and add it to a list
  * @param rl    RegexList to add to
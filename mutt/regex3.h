@@ -84,6 +84,7 @@ struct ReplaceListNode
 STAILQ_HEAD(ReplaceList, ReplaceListNode);
 
 struct Regex *mutt_regex_compile(const char *str, int flags);
+size_t        mutt_regex_literal(const char *str, int flags, char *buf, size_t buflen);
 struct Regex *mutt_regex_new(const char *str, int flags, struct Buffer *err);
 void          mutt_regex_free(struct Regex **r);
 
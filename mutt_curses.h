@@ -182,6 +182,7 @@ struct ColorLine
   regex_t regex;
   int match; /**< which substringmap 0 for old behaviour */
   char *pattern;
+  char *literal; /**< text that every match must contain, see mutt_color_prefilter() */
   struct PatternHead *color_pattern; /**< compiled pattern to speed up index color
                                           calculation */
   uint32_t fg;
@@ -189,7 +190,9 @@ struct ColorLine
   int pair;
   STAILQ_ENTRY(ColorLine) entries;
 
-  bool stop_matching : 1; ///< used by the pager for body patterns, to prevent the color from being retried once it fails
+  bool stop_matching : 1; /**< used by the pager for body patterns, to prevent the color from being retried once it fails */
+  bool context_free : 1;  /**< a match doesn't depend on the text before it, e.g. no \< or ^ */
+  regmatch_t next_match;  /**< used by the pager for context-free body patterns, the next match in the line */
 };
 STAILQ_HEAD(ColorLineHead, ColorLine);
 
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * Wait for input from the keyboard and other sources
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_poll Wait for input from the keyboard and other sources
+ *
+ * While NeoMutt waits for a key, it can also watch other file descriptors,
+ * e.g. the filesystem monitor or an IMAP connection in IDLE.  When one of them
+ * becomes readable, its handler is called and the wait ends, as if it had
+ * timed out, so that the caller can update the screen.
+ *
+ * If no sources are registered, the keyboard is read by curses, as usual.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "mutt_poll.h"
+
+bool PollSourceReady = false;
+
+/**
+ * struct PollSource - A file descriptor to watch while waiting for a key
+ */
+struct PollSource
+{
+  poll_handler_t handler; ///< Function to read the input
+  void *data;             ///< Private data for the handler
+};
+
+static struct pollfd *PollFds = NULL;        ///< Keyboard, then the sources
+static struct PollSource *PollSources = NULL; ///< Handlers, parallel to PollFds
+static size_t PollFdsCount = 0;
+static size_t PollFdsLen = 0;
+
+/**
+ * mutt_poll_add - Watch a file descriptor while waiting for a key
+ * @param fd      File descriptor to watch
+ * @param handler Function to call when the fd is readable
+ * @param data    Private data for the handler
+ *
+ * If the fd is already being watched, its handler is replaced.
+ */
+void mutt_poll_add(int fd, poll_handler_t handler, void *data)
+{
+  if (fd < 0)
+    return;
+
+  if (PollFdsCount == 0)
+  {
+    /* the keyboard is always first */
+    PollFdsLen = 4;
+    PollFds = mutt_mem_calloc(PollFdsLen, sizeof(struct pollfd));
+    PollSources = mutt_mem_calloc(PollFdsLen, sizeof(struct PollSource));
+    PollFds[0].fd = 0;
+    PollFds[0].events = POLLIN;
+    PollFdsCount = 1;
+  }
+
+  size_t i = 1;
+  for (; (i < PollFdsCount) && (PollFds[i].fd != fd); i++)
+    ;
+
+  if (i == PollFdsCount)
+  {
+    if (PollFdsCount == PollFdsLen)
+    {
+      PollFdsLen += 4;
+      mutt_mem_realloc(&PollFds, PollFdsLen * sizeof(struct pollfd));
+      mutt_mem_realloc(&PollSources, PollFdsLen * sizeof(struct PollSource));
+    }
+    PollFdsCount++;
+    PollFds[i].fd = fd;
+    PollFds[i].events = POLLIN;
+  }
+
+  PollSources[i].handler = handler;
+  PollSources[i].data = data;
+}
+
+/**
+ * mutt_poll_remove - Stop watching a file descriptor
+ * @param fd File descriptor
+ */
+void mutt_poll_remove(int fd)
+{
+  size_t i = 1;
+  for (; (i < PollFdsCount) && (PollFds[i].fd != fd); i++)
+    ;
+  if (i >= PollFdsCount)
+    return;
+
+  const size_t d = PollFdsCount - i - 1;
+  if (d != 0)
+  {
+    memmove(&PollFds[i], &PollFds[i + 1], d * sizeof(struct pollfd));
+    memmove(&PollSources[i], &PollSources[i + 1], d * sizeof(struct PollSource));
+  }
+  PollFdsCount--;
+
+  if (PollFdsCount == 1)
+  {
+    FREE(&PollFds);
+    FREE(&PollSources);
+    PollFdsCount = 0;
+    PollFdsLen = 0;
+  }
+}
+
+/**
+ * mutt_poll_active - Are there any sources, other than the keyboard?
+ * @retval true Input should be waited for with mutt_poll_wait()
+ */
+bool mutt_poll_active(void)
+{
+  return PollFdsCount > 1;
+}
+
+/**
+ * mutt_poll_wait - Wait for a key, or for a source to become readable
+ * @param timeout Milliseconds to wait, or -1 to wait forever
+ * @retval  0 Input is ready on the keyboard, or there are no sources
+ * @retval -1 Error (see errno)
+ * @retval -2 A source was handled, no keyboard input
+ * @retval -3 Timeout
+ *
+ * PollSourceReady is set if any source was handled.
+ */
+int mutt_poll_wait(int timeout)
+{
+  PollSourceReady = false;
+
+  if (PollFdsCount < 2)
+    return 0;
+
+  int fds = poll(PollFds, PollFdsCount, timeout);
+  if (fds == -1)
+  {
+    if (errno != EINTR)
+      mutt_debug(LL_DEBUG2, "poll() failed, errno=%d %s\n", errno, strerror(errno));
+    return -1;
+  }
+  if (fds == 0)
+    return -3;
+
+  const bool input_ready = PollFds[0].revents;
+
+  /* A handler may remove its own source, so look up each fd again */
+  for (size_t i = 1; i < PollFdsCount; i++)
+  {
+    if (!PollFds[i].revents)
+      continue;
+
+    const int fd = PollFds[i].fd;
+    PollFds[i].revents = 0;
+    PollSourceReady = true;
+    PollSources[i].handler(fd, PollSources[i].data);
+    if ((i < PollFdsCount) && (PollFds[i].fd != fd))
+      i--;
+  }
+
+  if (input_ready)
+    return 0;
+  return PollSourceReady ? -2 : -3;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * Wait for input from the keyboard and other sources
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MUTT_POLL_H
+#define MUTT_MUTT_POLL_H
+
+#include <stdbool.h>
+
+/**
+ * typedef poll_handler_t - Handle input from a source
+ * @param fd   File descriptor that is ready
+ * @param data Private data passed to mutt_poll_add()
+ */
+typedef void (*poll_handler_t)(int fd, void *data);
+
+extern bool PollSourceReady; ///< true after a source, other than the keyboard, has been handled
+
+void mutt_poll_add(int fd, poll_handler_t handler, void *data);
+void mutt_poll_remove(int fd);
+bool mutt_poll_active(void);
+int  mutt_poll_wait(int timeout);
+
+#endif /* MUTT_MUTT_POLL_H */
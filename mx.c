@@ -408,6 +408,8 @@ void mx_fastclose_mailbox(struct Mailbox *m)
     FREE(&m->emails);
   }
   FREE(&m->v2r);
+
+  rfc2047_decode_cleanup();
 }
 
 /**
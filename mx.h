@@ -71,6 +71,7 @@ enum MxCheckReturns
   MUTT_LOCKED,       ///< Couldn't lock the Mailbox
   MUTT_REOPENED,     ///< Mailbox was reopened
   MUTT_FLAGS,        ///< Nondestructive flags change (IMAP)
+  MUTT_BACKFILL,     ///< Older emails were loaded (IMAP)
 };
 
 /**
@@ -1711,7 +1711,8 @@ struct Body *pgp_class_traditional_encryptsign(struct Body *a, SecurityFlags fla
 
   if (!mutt_ch_is_us_ascii(body_charset))
   {
-    int c;
+    char bufc[4096];
+    size_t len;
     struct FgetConv *fc = NULL;
 
     if (flags & SEC_ENCRYPT)
@@ -1721,8 +1722,8 @@ struct Body *pgp_class_traditional_encryptsign(struct Body *a, SecurityFlags fla
 
     /* fromcode is assumed to be correct: we set flags to 0 */
     fc = mutt_ch_fgetconv_open(fp_body, from_charset, "utf-8", 0);
-    while ((c = mutt_ch_fgetconv(fc)) != EOF)
-      fputc(c, fp_pgp_in);
+    while ((len = mutt_ch_fgetconv_read(fc, bufc, sizeof(bufc))) != 0)
+      fwrite(bufc, 1, len, fp_pgp_in);
 
     mutt_ch_fgetconv_close(&fc);
   }
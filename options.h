@@ -43,6 +43,9 @@ WHERE bool OptNews;                 /**< (pseudo) used to change reader mode */
 WHERE bool OptNewsSend;            /**< (pseudo) used to change behavior when posting */
 #endif
 WHERE bool OptNoCurses;            /**< (pseudo) when sending in batch mode */
+WHERE bool OptPagerRecolor;        /**< (pseudo) the body, header or attachment colours have changed */
+WHERE bool OptPagerStream;         /**< (pseudo) decoding a message for the pager in the background */
+WHERE bool OptPartialFetch;        /**< (pseudo) only fetch the parts of an IMAP message needed to display it */
 WHERE bool OptPgpCheckTrust;      /**< (pseudo) used by pgp_select_key () */
 WHERE bool OptRedrawTree;          /**< (pseudo) redraw the thread tree */
 WHERE bool OptResortInit;          /**< (pseudo) used to force the next resort to be from scratch */
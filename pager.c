@@ -60,6 +60,7 @@
 #include "mutt_header.h"
 #include "mutt_logging.h"
 #include "mutt_menu.h"
+#include "mutt_poll.h"
 #include "mutt_window.h"
 #include "muttlib.h"
 #include "mx.h"
@@ -183,6 +184,55 @@ struct Line
   unsigned int is_cont_hdr; /**< this line is a continuation of the previous header line */
 };
 
+/**
+ * struct LineLayout - Width-independent attributes of a line of the file
+ *
+ * How a line is wrapped depends on the width of the window, but its
+ * classification (header, quoting, signature, colour spans) doesn't.
+ */
+struct LineLayout
+{
+  LOFF_T offset;            ///< Offset of the line in the file
+  short type;               ///< Line type, e.g. #MT_COLOR_QUOTED
+  short chunks;             ///< Number of colour spans in syntax
+  unsigned int is_cont_hdr; ///< Line is a continuation of the previous header line
+  struct Syntax *syntax;    ///< Colour spans, or the header colour
+  struct QClass *quote;     ///< Quoting style
+};
+
+/**
+ * struct LayoutCache - Classification of the lines the pager has seen
+ *
+ * This is kept across a reflow, so that a resize, or a change of $wrap, only
+ * needs to recompute the wrapping and not re-run all the colour regexes.
+ */
+struct LayoutCache
+{
+  struct LineLayout *lines; ///< Lines, sorted by offset
+  int num;                  ///< Number of lines used
+  int max;                  ///< Number of lines allocated
+  bool stale;               ///< Colours or config have changed; discard at the next reflow
+};
+
+/**
+ * struct SearchIndex - Plain text of the file, for searching
+ *
+ * The text of each line, stripped of attributes and markers, is copied into a
+ * single buffer while the pager is idle.  A search is then one scan of the
+ * buffer, rather than a regexec() of every line.
+ */
+struct SearchIndex
+{
+  char *text;      ///< Text of every line, each ending in a newline
+  size_t len;      ///< Length of text
+  size_t size;     ///< Allocated size of text
+  LOFF_T *offsets; ///< Offset in the file of each line
+  size_t *starts;  ///< Position in text of each line
+  int num;         ///< Number of lines used
+  int max;         ///< Number of lines allocated
+  LOFF_T end;      ///< Offset in the file of the next line to index
+};
+
 // clang-format off
 typedef uint8_t AnsiFlags;      ///< Flags, e.g. #ANSI_OFF
 #define ANSI_NO_FLAGS        0  ///< No flags are set
@@ -218,6 +268,8 @@ static struct Resize
 } *Resize = NULL;
 
 #define NUM_SIG_LINES 4
+#define SEARCH_INDEX_STEP (256 * 1024) ///< Bytes of the file to index at a time
+#define SEARCH_LAYOUT_STEP 4096        ///< Lines to lay out at a time
 
 /**
  * check_sig - Check for an email signature
@@ -413,6 +465,118 @@ static void resolve_color(struct Line *line_info, int n, int cnt,
   }
 }
 
+/**
+ * layout_find - Find the cached classification of a line
+ * @param lc     Layout cache
+ * @param offset Offset of the line in the file
+ * @retval ptr  Cached classification
+ * @retval NULL Line hasn't been classified
+ */
+static struct LineLayout *layout_find(struct LayoutCache *lc, LOFF_T offset)
+{
+  if (!lc)
+    return NULL;
+
+  int lo = 0;
+  int hi = lc->num - 1;
+  while (lo <= hi)
+  {
+    const int mid = lo + (hi - lo) / 2;
+    if (lc->lines[mid].offset < offset)
+      lo = mid + 1;
+    else if (lc->lines[mid].offset > offset)
+      hi = mid - 1;
+    else
+      return &lc->lines[mid];
+  }
+  return NULL;
+}
+
+/**
+ * layout_save - Remember the classification of the lines before a reflow
+ * @param lc        Layout cache
+ * @param line_info Line info array
+ * @param last      Number of lines in line_info
+ *
+ * The colour spans are moved into the cache, rather than copied.
+ */
+static void layout_save(struct LayoutCache *lc, struct Line *line_info, int last)
+{
+  for (int i = 0; i < last; i++)
+  {
+    struct Line *li = &line_info[i];
+    if (li->continuation || (li->type == -1))
+      continue;
+
+    struct LineLayout *ll = layout_find(lc, li->offset);
+    if (ll)
+    {
+      FREE(&ll->syntax);
+    }
+    else
+    {
+      /* Lines are always laid out from the top, so new ones go at the end */
+      if ((lc->num > 0) && (li->offset < lc->lines[lc->num - 1].offset))
+        continue;
+      if (lc->num == lc->max)
+      {
+        lc->max += 256;
+        mutt_mem_realloc(&lc->lines, lc->max * sizeof(struct LineLayout));
+      }
+      ll = &lc->lines[lc->num++];
+      ll->offset = li->offset;
+    }
+
+    ll->type = li->type;
+    ll->chunks = li->chunks;
+    ll->is_cont_hdr = li->is_cont_hdr;
+    ll->quote = li->quote;
+    ll->syntax = li->syntax;
+    li->syntax = mutt_mem_malloc(sizeof(struct Syntax));
+  }
+}
+
+/**
+ * layout_restore - Classify a line using the layout cache
+ * @param lc        Layout cache
+ * @param line_info Line info array
+ * @param n         Line number (index into line_info)
+ * @retval true  The line's classification was found
+ * @retval false The line hasn't been classified yet
+ */
+static bool layout_restore(struct LayoutCache *lc, struct Line *line_info, int n)
+{
+  if (line_info[n].continuation)
+    return false;
+
+  struct LineLayout *ll = layout_find(lc, line_info[n].offset);
+  if (!ll)
+    return false;
+
+  const size_t len = MAX(ll->chunks, 1) * sizeof(struct Syntax);
+  mutt_mem_realloc(&line_info[n].syntax, len);
+  memcpy(line_info[n].syntax, ll->syntax, len);
+  line_info[n].type = ll->type;
+  line_info[n].chunks = ll->chunks;
+  line_info[n].is_cont_hdr = ll->is_cont_hdr;
+  line_info[n].quote = ll->quote;
+  return true;
+}
+
+/**
+ * layout_free - Empty the layout cache
+ * @param lc Layout cache
+ */
+static void layout_free(struct LayoutCache *lc)
+{
+  for (int i = 0; i < lc->num; i++)
+    FREE(&lc->lines[i].syntax);
+  FREE(&lc->lines);
+  lc->num = 0;
+  lc->max = 0;
+  lc->stale = false;
+}
+
 /**
  * append_line - Add a new Line to the array
  * @param line_info Array of Line info
@@ -1046,10 +1210,8 @@ static void resolve_types(char *buf, char *raw, struct Line *line_info, int n,
       head = &ColorHdrList;
     else
       head = &ColorBodyList;
-    STAILQ_FOREACH(color_line, head, entries)
-    {
-      color_line->stop_matching = false;
-    }
+    /* skip the patterns that can't match this line */
+    mutt_color_prefilter(head, buf);
     do
     {
       if (!buf[offset])
@@ -1059,43 +1221,21 @@ static void resolve_types(char *buf, char *raw, struct Line *line_info, int n,
       null_rx = false;
       STAILQ_FOREACH(color_line, head, entries)
       {
-        if (!color_line->stop_matching &&
-            (regexec(&color_line->regex, buf + offset, 1, pmatch,
-                     ((offset != 0) ? REG_NOTBOL : 0)) == 0))
+        if (color_line->stop_matching)
+          continue;
+
+        if (color_line->next_match.rm_so >= offset)
         {
-          if (pmatch[0].rm_eo != pmatch[0].rm_so)
-          {
-            if (!found)
-            {
-              /* Abort if we fill up chunks.
-               * Yes, this really happened. See #3888 */
-              if (line_info[n].chunks == SHRT_MAX)
-              {
-                null_rx = false;
-                break;
-              }
-              if (++(line_info[n].chunks) > 1)
-              {
-                mutt_mem_realloc(&(line_info[n].syntax),
-                                 (line_info[n].chunks) * sizeof(struct Syntax));
-              }
-            }
-            i = line_info[n].chunks - 1;
-            pmatch[0].rm_so += offset;
-            pmatch[0].rm_eo += offset;
-            if (!found || (pmatch[0].rm_so < (line_info[n].syntax)[i].first) ||
-                ((pmatch[0].rm_so == (line_info[n].syntax)[i].first) &&
-                 (pmatch[0].rm_eo > (line_info[n].syntax)[i].last)))
-            {
-              (line_info[n].syntax)[i].color = color_line->pair;
-              (line_info[n].syntax)[i].first = pmatch[0].rm_so;
-              (line_info[n].syntax)[i].last = pmatch[0].rm_eo;
-            }
-            found = true;
-            null_rx = false;
-          }
-          else
-            null_rx = true; /* empty regex; don't add it, but keep looking */
+          /* the pattern's next match is still ahead of us */
+          pmatch[0] = color_line->next_match;
+        }
+        else if (regexec(&color_line->regex, buf + offset, 1, pmatch,
+                         ((offset != 0) ? REG_NOTBOL : 0)) == 0)
+        {
+          pmatch[0].rm_so += offset;
+          pmatch[0].rm_eo += offset;
+          if (color_line->context_free)
+            color_line->next_match = pmatch[0];
         }
         else
         {
@@ -1103,7 +1243,40 @@ static void resolve_types(char *buf, char *raw, struct Line *line_info, int n,
            * On very long lines this can cause a performance issue if there
            * are other regexps that have many matches. */
           color_line->stop_matching = true;
+          continue;
+        }
+
+        if (pmatch[0].rm_eo != pmatch[0].rm_so)
+        {
+          if (!found)
+          {
+            /* Abort if we fill up chunks.
+             * Yes, this really happened. See #3888 */
+            if (line_info[n].chunks == SHRT_MAX)
+            {
+              null_rx = false;
+              break;
+            }
+            if (++(line_info[n].chunks) > 1)
+            {
+              mutt_mem_realloc(&(line_info[n].syntax),
+                               (line_info[n].chunks) * sizeof(struct Syntax));
+            }
+          }
+          i = line_info[n].chunks - 1;
+          if (!found || (pmatch[0].rm_so < (line_info[n].syntax)[i].first) ||
+              ((pmatch[0].rm_so == (line_info[n].syntax)[i].first) &&
+               (pmatch[0].rm_eo > (line_info[n].syntax)[i].last)))
+          {
+            (line_info[n].syntax)[i].color = color_line->pair;
+            (line_info[n].syntax)[i].first = pmatch[0].rm_so;
+            (line_info[n].syntax)[i].last = pmatch[0].rm_eo;
+          }
+          found = true;
+          null_rx = false;
         }
+        else
+          null_rx = true; /* empty regex; don't add it, but keep looking */
       }
 
       if (null_rx)
@@ -1356,6 +1529,220 @@ static int fill_buffer(FILE *fp, LOFF_T *last_pos, LOFF_T offset, unsigned char
   return b_read;
 }
 
+/**
+ * search_index_build - Add lines of the file to the search index
+ * @param idx      Search index
+ * @param fp       File to read from
+ * @param last_pos End of last read
+ * @param size     Size of the file
+ * @param limit    Stop after reading this many bytes, 0 for no limit
+ */
+static void search_index_build(struct SearchIndex *idx, FILE *fp, LOFF_T *last_pos,
+                               LOFF_T size, LOFF_T limit)
+{
+  unsigned char *buf = NULL, *fmt = NULL;
+  size_t buflen = 0;
+  const LOFF_T stop = (limit > 0) ? MIN(size, idx->end + limit) : size;
+
+  while (idx->end < stop)
+  {
+    int buf_ready = 0;
+    int b_read = fill_buffer(fp, last_pos, idx->end, &buf, &fmt, &buflen, &buf_ready);
+    if (b_read <= 0)
+      break;
+
+    if (idx->num == idx->max)
+    {
+      idx->max = MAX(1024, idx->max * 2);
+      mutt_mem_realloc(&idx->offsets, idx->max * sizeof(LOFF_T));
+      mutt_mem_realloc(&idx->starts, idx->max * sizeof(size_t));
+    }
+
+    const size_t len = mutt_str_strlen((char *) fmt);
+    if ((idx->len + len + 2) > idx->size)
+    {
+      idx->size = MAX(idx->len + len + 2, idx->size * 2);
+      mutt_mem_realloc(&idx->text, idx->size);
+    }
+
+    idx->offsets[idx->num] = idx->end;
+    idx->starts[idx->num] = idx->len;
+    idx->num++;
+
+    memcpy(idx->text + idx->len, fmt, len);
+    idx->len += len;
+    /* Keep the lines apart, even if the last one has no newline */
+    if ((len == 0) || (fmt[len - 1] != '\n'))
+      idx->text[idx->len++] = '\n';
+    idx->text[idx->len] = '\0';
+
+    idx->end += b_read;
+  }
+
+  FREE(&buf);
+  FREE(&fmt);
+}
+
+/**
+ * search_index_free - Free the search index
+ * @param idx Search index
+ */
+static void search_index_free(struct SearchIndex *idx)
+{
+  FREE(&idx->text);
+  FREE(&idx->offsets);
+  FREE(&idx->starts);
+  memset(idx, 0, sizeof(*idx));
+}
+
+/**
+ * search_index_line - Find the first line at, or after, an offset
+ * @param idx    Search index
+ * @param offset Offset in the file
+ * @retval num Index of the line, or idx->num if there isn't one
+ */
+static int search_index_line(struct SearchIndex *idx, LOFF_T offset)
+{
+  int lo = 0;
+  int hi = idx->num;
+  while (lo < hi)
+  {
+    const int mid = lo + (hi - lo) / 2;
+    if (idx->offsets[mid] < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * search_index_text_line - Find the line containing a position in the text
+ * @param idx Search index
+ * @param pos Position in idx->text
+ * @retval num Index of the line
+ */
+static int search_index_text_line(struct SearchIndex *idx, size_t pos)
+{
+  int lo = 0;
+  int hi = idx->num - 1;
+  while (lo < hi)
+  {
+    const int mid = lo + (hi - lo + 1) / 2;
+    if (idx->starts[mid] <= pos)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return lo;
+}
+
+/**
+ * search_index_match - Does a line of the search index match?
+ * @param idx Search index
+ * @param re  Regex to match
+ * @param n   Line number
+ * @retval true The line matches
+ *
+ * The regex is tried against the line on its own, like the pager would, so a
+ * match can't run into the next line.
+ */
+static bool search_index_match(struct SearchIndex *idx, regex_t *re, int n)
+{
+  const size_t end = (n + 1 < idx->num) ? idx->starts[n + 1] : idx->len;
+  const char save = idx->text[end];
+  idx->text[end] = '\0';
+  const bool match = (regexec(re, idx->text + idx->starts[n], 0, NULL, 0) == 0);
+  idx->text[end] = save;
+  return match;
+}
+
+/**
+ * search_index_scan - Scan a range of the search index
+ * @param idx     Search index
+ * @param re      Regex to match
+ * @param literal Text any match must contain, or empty
+ * @param icase   true if literal should be matched ignoring case
+ * @param first   First line to search
+ * @param last    Line after the last one to search
+ * @param reverse If true, find the last match, not the first
+ * @retval num Index of the matching line
+ * @retval -1  No line matches
+ */
+static int search_index_scan(struct SearchIndex *idx, regex_t *re, const char *literal,
+                             bool icase, int first, int last, bool reverse)
+{
+  if ((first >= last) || (first >= idx->num))
+    return -1;
+
+  /* Limit the scan to the lines in range */
+  const size_t end = (last < idx->num) ? idx->starts[last] : idx->len;
+  const char save = idx->text[end];
+  idx->text[end] = '\0';
+
+  int found = -1;
+  size_t pos = idx->starts[first];
+  regmatch_t pmatch[1];
+  while (pos < end)
+  {
+    const char *hit = NULL;
+    if (*literal)
+      hit = icase ? strcasestr(idx->text + pos, literal) : strstr(idx->text + pos, literal);
+    else if (regexec(re, idx->text + pos, 1, pmatch, 0) == 0)
+      hit = idx->text + pos + pmatch[0].rm_so;
+    if (!hit)
+      break;
+
+    const int n = search_index_text_line(idx, hit - idx->text);
+    idx->text[end] = save;
+    const bool match = search_index_match(idx, re, n);
+    idx->text[end] = '\0';
+    if (match)
+    {
+      found = n;
+      if (!reverse)
+        break;
+    }
+    pos = (n + 1 < idx->num) ? idx->starts[n + 1] : idx->len;
+  }
+
+  idx->text[end] = save;
+  return found;
+}
+
+/**
+ * search_index_find - Find a matching line in the search index
+ * @param idx     Search index
+ * @param re      Regex to match
+ * @param literal Text any match must contain, or empty
+ * @param icase   true if literal should be matched ignoring case
+ * @param first   First line to search
+ * @param last    Line after the last one to search
+ * @param reverse If true, find the last match, not the first
+ * @retval num Index of the matching line
+ * @retval -1  No line matches
+ */
+static int search_index_find(struct SearchIndex *idx, regex_t *re, const char *literal,
+                             bool icase, int first, int last, bool reverse)
+{
+  if (!reverse)
+    return search_index_scan(idx, re, literal, icase, first, last, false);
+
+  /* Work backwards in ever larger blocks, so a nearby match is found quickly */
+  int step = 256;
+  for (int hi = MIN(last, idx->num); hi > first;)
+  {
+    const int lo = MAX(first, hi - step);
+    const int n = search_index_scan(idx, re, literal, icase, lo, hi, true);
+    if (n >= 0)
+      return n;
+    hi = lo;
+    if (step < (INT_MAX / 2))
+      step *= 2;
+  }
+  return -1;
+}
+
 /**
  * format_line - Display a line of text in the pager
  * @param[out] line_info    Line info
@@ -1550,6 +1937,7 @@ static int format_line(struct Line **line_info, int n, unsigned char *buf,
  * @param[in]  fp              File to read from
  * @param[out] last_pos        Offset into file
  * @param[out] line_info       Line attributes
+ * @param[in]  layout          Cached line classification (optional)
  * @param[in]  n               Line number
  * @param[out] last            Last line
  * @param[out] max             Maximum number of lines
@@ -1564,7 +1952,7 @@ static int format_line(struct Line **line_info, int n, unsigned char *buf,
  * @retval >0 normal exit, line was displayed
  */
 static int display_line(FILE *fp, LOFF_T *last_pos, struct Line **line_info,
-                        int n, int *last, int *max, PagerFlags flags,
+                        struct LayoutCache *layout, int n, int *last, int *max, PagerFlags flags,
                         struct QClass **quote_list, int *q_level, bool *force_redraw,
                         regex_t *search_re, struct MuttWindow *pager_window)
 {
@@ -1624,7 +2012,13 @@ static int display_line(FILE *fp, LOFF_T *last_pos, struct Line **line_info,
   /* only do color highlighting if we are viewing a message */
   if (flags & (MUTT_SHOWCOLOR | MUTT_TYPES))
   {
-    if ((*line_info)[n].type == -1)
+    if (((*line_info)[n].type == -1) && layout_restore(layout, *line_info, n))
+    {
+      /* avoid race condition for continuation lines when scrolling up */
+      for (m = n + 1; m < *last && (*line_info)[m].offset && (*line_info)[m].continuation; m++)
+        (*line_info)[m].type = (*line_info)[n].type;
+    }
+    else if ((*line_info)[n].type == -1)
     {
       /* determine the line class */
       if (fill_buffer(fp, last_pos, (*line_info)[n].offset, &buf, &fmt, &buflen, &buf_ready) < 0)
@@ -1831,6 +2225,16 @@ out:
   return rc;
 }
 
+/**
+ * stream_pending - Is more of the message still to come?
+ * @param extra Info about email to display
+ * @retval true The message is still being decoded
+ */
+static bool stream_pending(struct Pager *extra)
+{
+  return extra && extra->stream && (extra->stream->fd != -1);
+}
+
 /**
  * up_n_lines - Reposition the pager's view up by n lines
  * @param nlines Number of lines to move
@@ -1920,10 +2324,170 @@ struct PagerRedrawData
   const char *helpstr;
   char *searchbuf;
   struct Line *line_info;
+  struct LayoutCache layout;
+  struct SearchIndex search_index;
   FILE *fp;
   struct stat sb;
 };
 
+/**
+ * pager_scan_to - Work out the wrapping of the file as far as a line
+ * @param rd Pager data
+ * @param n  Line number
+ * @retval true  Line n exists
+ * @retval false The file ends before line n
+ */
+static bool pager_scan_to(struct PagerRedrawData *rd, int n)
+{
+  while (rd->last_line <= n)
+  {
+    if (display_line(rd->fp, &rd->last_pos, &rd->line_info, &rd->layout, rd->last_line,
+                     &rd->last_line, &rd->max_line,
+                     MUTT_TYPES | (rd->flags & MUTT_PAGER_NSKIP) | (rd->flags & MUTT_PAGER_NOWRAP),
+                     &rd->quote_list, &rd->q_level, &rd->force_redraw,
+                     &rd->search_re, rd->pager_window) < 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * pager_line_at - Find the pager line that starts a line of the file
+ * @param rd     Pager data
+ * @param offset Offset of the line in the file
+ * @retval num Line number
+ */
+static int pager_line_at(struct PagerRedrawData *rd, LOFF_T offset)
+{
+  while (((rd->last_line == 0) || (rd->line_info[rd->last_line - 1].offset < offset)) &&
+         pager_scan_to(rd, rd->last_line))
+  {
+  }
+
+  int lo = 0;
+  int hi = rd->last_line;
+  while (lo < hi)
+  {
+    const int mid = lo + (hi - lo) / 2;
+    if (rd->line_info[mid].offset < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * pager_search_pending - Is there work to do before the next search?
+ * @param rd Pager data
+ * @retval true pager_search_prepare() has work to do
+ */
+static bool pager_search_pending(struct PagerRedrawData *rd)
+{
+  /* Most messages are never searched.  Once the user has searched, they'll
+   * probably search again. */
+  if (!rd->search_compiled)
+    return false;
+
+  return (rd->search_index.end < rd->sb.st_size) ||
+         (rd->line_info[rd->last_line].offset < rd->sb.st_size);
+}
+
+/**
+ * pager_search_prepare - Do some of the work of a search in advance
+ * @param rd Pager data
+ * @retval true  Some work was done
+ * @retval false No progress could be made
+ *
+ * First the text is indexed, then the lines are laid out, so that a match
+ * can be shown without delay.
+ */
+static bool pager_search_prepare(struct PagerRedrawData *rd)
+{
+  struct SearchIndex *idx = &rd->search_index;
+  if (idx->end < rd->sb.st_size)
+  {
+    const LOFF_T end = idx->end;
+    search_index_build(idx, rd->fp, &rd->last_pos, rd->sb.st_size, SEARCH_INDEX_STEP);
+    return idx->end > end;
+  }
+
+  return pager_scan_to(rd, rd->last_line + SEARCH_LAYOUT_STEP);
+}
+
+/**
+ * pager_search - Find the next line that matches the search
+ * @param rd      Pager data
+ * @param from    Line to start at, or INT_MAX for the end of the file
+ * @param reverse If true, search backwards
+ * @retval num Line number of the match
+ * @retval -1  Not found
+ *
+ * Only the line numbers of the matches are found here.  The matches
+ * themselves are highlighted by display_line() when the lines are shown.
+ */
+static int pager_search(struct PagerRedrawData *rd, int from, bool reverse)
+{
+  struct SearchIndex *idx = &rd->search_index;
+
+  /* A match may be in the part of the message that's still being decoded.
+   * A key, or ^C, stops the wait and searches the text decoded so far. */
+  if (stream_pending(rd->extra))
+  {
+    mutt_message(_("Searching..."));
+    SigInt = 0;
+    mutt_sig_allow_interrupt(1);
+    while (stream_pending(rd->extra) && !SigInt && (mutt_poll_wait(100) != 0))
+      ;
+    mutt_sig_allow_interrupt(0);
+    SigInt = 0;
+    mutt_clear_error();
+    fstat(fileno(rd->fp), &rd->sb);
+    clearerr(rd->fp);
+  }
+
+  search_index_build(idx, rd->fp, &rd->last_pos, rd->sb.st_size, 0);
+
+  if (from < 0)
+    return -1;
+
+  /* A fast scan for the text every match must contain */
+  char literal[128];
+  const bool icase = mutt_mb_is_lower(rd->searchbuf);
+  const size_t len = mutt_regex_literal(rd->searchbuf, icase ? REG_ICASE : 0,
+                                        literal, sizeof(literal) - 1);
+  literal[len] = '\0';
+
+  int first = 0;
+  int last = idx->num;
+  if (from == INT_MAX)
+    ; /* the whole file */
+  else if (!pager_scan_to(rd, from))
+    first = reverse ? 0 : idx->num;
+  else if (reverse)
+    last = search_index_line(idx, rd->line_info[from].offset + 1);
+  else
+    first = search_index_line(idx, rd->line_info[from].offset);
+
+  while (true)
+  {
+    const int n = search_index_find(idx, &rd->search_re, literal, icase, first, last, reverse);
+    if (n < 0)
+      return -1;
+
+    const int line = pager_line_at(rd, idx->offsets[n]);
+    if (!rd->hide_quoted || (rd->line_info[line].type != MT_COLOR_QUOTED))
+      return line;
+
+    if (reverse)
+      last = n;
+    else
+      first = n + 1;
+  }
+}
+
 /**
  * pager_custom_redraw - Redraw the pager window - Implements Menu::menu_custom_redraw()
  */
@@ -2063,6 +2627,13 @@ static void pager_custom_redraw(struct Menu *pager_menu)
       for (int i = 0; i <= rd->topline; i++)
         if (!rd->line_info[i].continuation)
           rd->lines++;
+
+      /* Keep the lines' classification; only the wrapping needs recomputing */
+      if (rd->layout.stale)
+        layout_free(&rd->layout);
+      else
+        layout_save(&rd->layout, rd->line_info, rd->last_line);
+
       for (int i = 0; i < rd->max_line; i++)
       {
         rd->line_info[i].offset = 0;
@@ -2082,16 +2653,15 @@ static void pager_custom_redraw(struct Menu *pager_menu)
     }
     int i = -1;
     int j = -1;
-    while (display_line(rd->fp, &rd->last_pos, &rd->line_info, ++i, &rd->last_line,
-                        &rd->max_line, rd->has_types | rd->search_flag | (rd->flags & MUTT_PAGER_NOWRAP),
+    while (display_line(rd->fp, &rd->last_pos, &rd->line_info, &rd->layout, ++i, &rd->last_line,
+                        &rd->max_line, rd->has_types | (rd->flags & MUTT_PAGER_NOWRAP),
                         &rd->quote_list, &rd->q_level, &rd->force_redraw,
                         &rd->search_re, rd->pager_window) == 0)
     {
       if (!rd->line_info[i].continuation && (++j == rd->lines))
       {
         rd->topline = i;
-        if (!rd->search_flag)
-          break;
+        break;
       }
     }
   }
@@ -2116,7 +2686,7 @@ static void pager_custom_redraw(struct Menu *pager_menu)
       while ((rd->lines < rd->pager_window->rows) &&
              (rd->line_info[rd->curline].offset <= rd->sb.st_size - 1))
       {
-        if (display_line(rd->fp, &rd->last_pos, &rd->line_info, rd->curline,
+        if (display_line(rd->fp, &rd->last_pos, &rd->line_info, &rd->layout, rd->curline,
                          &rd->last_line, &rd->max_line,
                          (rd->flags & MUTT_DISPLAYFLAGS) | rd->hide_quoted |
                              rd->search_flag | (rd->flags & MUTT_PAGER_NOWRAP),
@@ -2360,6 +2930,18 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
     else
       OldHdr = NULL;
 
+    if (pager_search_pending(&rd) && !SigWinch)
+    {
+      /* Prepare for searching, while no key is waiting */
+      mutt_getch_timeout(0);
+      struct KeyEvent event = mutt_getch();
+      mutt_getch_timeout(-1);
+      if ((event.ch == -2) && pager_search_prepare(&rd))
+        continue;
+      if (event.ch != -2)
+        mutt_unget_event(event.ch, event.op);
+    }
+
     ch = km_dokey(MENU_PAGER);
     if (ch >= 0)
     {
@@ -2367,6 +2949,18 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
     }
     mutt_curs_set(1);
 
+    if (extra && extra->stream && extra->stream->changed)
+    {
+      /* More of the message has been decoded.  If the end was on screen,
+       * fill the rest of it. */
+      extra->stream->changed = false;
+      if (rd.last_offset >= rd.sb.st_size)
+        pager_menu->redraw |= REDRAW_BODY;
+      fstat(fileno(rd.fp), &rd.sb);
+      clearerr(rd.fp);
+      pager_menu->redraw |= REDRAW_STATUS;
+    }
+
     bool do_new_mail = false;
 
     if (Context && Context->mailbox && !OptAttachMsg)
@@ -2385,7 +2979,8 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
           break;
         }
       }
-      else if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED) || (check == MUTT_FLAGS))
+      else if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED) ||
+               (check == MUTT_FLAGS) || (check == MUTT_BACKFILL))
       {
         /* notify user of newly arrived mail */
         if (check == MUTT_NEW_MAIL)
@@ -2403,7 +2998,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
           }
         }
 
-        if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED))
+        if ((check == MUTT_NEW_MAIL) || (check == MUTT_REOPENED) || (check == MUTT_BACKFILL))
         {
           if (rd.index && Context)
           {
@@ -2489,7 +3084,8 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
     if (ch < 0)
     {
       ch = 0;
-      mutt_timeout_hook();
+      if (!PollSourceReady)
+        mutt_timeout_hook();
       continue;
     }
 
@@ -2516,7 +3112,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
         {
           rd.topline = up_n_lines(C_PagerContext, rd.line_info, rd.curline, rd.hide_quoted);
         }
-        else if (C_PagerStop)
+        else if (C_PagerStop || stream_pending(extra))
         {
           /* emulate "less -q" and don't go on to the next message. */
           mutt_error(_("Bottom of message is shown"));
@@ -2586,7 +3182,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
           rd.topline = up_n_lines(rd.pager_window->rows / 2, rd.line_info,
                                   rd.curline, rd.hide_quoted);
         }
-        else if (C_PagerStop)
+        else if (C_PagerStop || stream_pending(extra))
         {
           /* emulate "less -q" and don't go on to the next message. */
           mutt_error(_("Bottom of message is shown"));
@@ -2611,67 +3207,39 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
             searchctx = 0;
 
         search_next:
-          if ((!rd.search_back && (ch == OP_SEARCH_NEXT)) ||
-              (rd.search_back && (ch == OP_SEARCH_OPPOSITE)))
-          {
-            /* searching forward */
-            int i;
-            for (i = wrapped ? 0 : rd.topline + searchctx + 1; i < rd.last_line; i++)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
-
-            if (i < rd.last_line)
-              rd.topline = i;
-            else if (wrapped || !C_WrapSearch)
-              mutt_error(_("Not found"));
-            else
-            {
-              mutt_message(_("Search wrapped to top"));
-              wrapped = true;
-              goto search_next;
-            }
-          }
+        {
+          const bool forward = (!rd.search_back && (ch == OP_SEARCH_NEXT)) ||
+                               (rd.search_back && (ch == OP_SEARCH_OPPOSITE));
+          int from;
+          if (forward)
+            from = wrapped ? 0 : rd.topline + searchctx + 1;
           else
-          {
-            /* searching backward */
-            int i;
-            for (i = wrapped ? rd.last_line : rd.topline + searchctx - 1; i >= 0; i--)
-            {
-              if ((!rd.hide_quoted ||
-                   (rd.has_types && (rd.line_info[i].type != MT_COLOR_QUOTED))) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
+            from = wrapped ? INT_MAX : rd.topline + searchctx - 1;
 
-            if (i >= 0)
-              rd.topline = i;
-            else if (wrapped || !C_WrapSearch)
-              mutt_error(_("Not found"));
-            else
-            {
-              mutt_message(_("Search wrapped to bottom"));
-              wrapped = true;
-              goto search_next;
-            }
-          }
-
-          if (rd.line_info[rd.topline].search_cnt > 0)
+          const int i = pager_search(&rd, from, !forward);
+          if (i >= 0)
           {
+            rd.topline = i;
             rd.search_flag = MUTT_SEARCH;
             /* give some context for search results */
             if (rd.topline - searchctx > 0)
               rd.topline -= searchctx;
           }
+          else if (wrapped || !C_WrapSearch)
+            mutt_error(_("Not found"));
+          else
+          {
+            if (forward)
+              mutt_message(_("Search wrapped to top"));
+            else
+              mutt_message(_("Search wrapped to bottom"));
+            wrapped = true;
+            goto search_next;
+          }
 
           break;
         }
+        }
         /* no previous search pattern */
         /* fallthrough */
 
@@ -2742,57 +3310,15 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
         else
         {
           rd.search_compiled = true;
-          /* update the search pointers */
-          int line_num = 0;
-          while (display_line(rd.fp, &rd.last_pos, &rd.line_info, line_num,
-                              &rd.last_line, &rd.max_line,
-                              MUTT_SEARCH | (flags & MUTT_PAGER_NSKIP) | (flags & MUTT_PAGER_NOWRAP),
-                              &rd.quote_list, &rd.q_level, &rd.force_redraw,
-                              &rd.search_re, rd.pager_window) == 0)
-          {
-            line_num++;
-          }
-
-          if (!rd.search_back)
-          {
-            /* searching forward */
-            int i;
-            for (i = rd.topline; i < rd.last_line; i++)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
-
-            if (i < rd.last_line)
-              rd.topline = i;
-          }
-          else
-          {
-            /* searching backward */
-            int i;
-            for (i = rd.topline; i >= 0; i--)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
-
-            if (i >= 0)
-              rd.topline = i;
-          }
-
-          if (rd.line_info[rd.topline].search_cnt == 0)
+          const int i = pager_search(&rd, rd.topline, rd.search_back);
+          if (i < 0)
           {
             rd.search_flag = 0;
             mutt_error(_("Not found"));
           }
           else
           {
+            rd.topline = i;
             rd.search_flag = MUTT_SEARCH;
             /* give some context for search results */
             if (C_SearchContext < rd.pager_window->rows)
@@ -2860,7 +3386,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
           {
             while (((new_topline < rd.last_line) ||
                     (0 == (dretval = display_line(
-                               rd.fp, &rd.last_pos, &rd.line_info, new_topline, &rd.last_line,
+                               rd.fp, &rd.last_pos, &rd.line_info, &rd.layout, new_topline, &rd.last_line,
                                &rd.max_line, MUTT_TYPES | (flags & MUTT_PAGER_NOWRAP),
                                &rd.quote_list, &rd.q_level, &rd.force_redraw,
                                &rd.search_re, rd.pager_window)))) &&
@@ -2874,7 +3400,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
 
           while ((((new_topline + C_SkipQuotedOffset) < rd.last_line) ||
                   (0 == (dretval = display_line(
-                             rd.fp, &rd.last_pos, &rd.line_info, new_topline, &rd.last_line,
+                             rd.fp, &rd.last_pos, &rd.line_info, &rd.layout, new_topline, &rd.last_line,
                              &rd.max_line, MUTT_TYPES | (flags & MUTT_PAGER_NOWRAP),
                              &rd.quote_list, &rd.q_level, &rd.force_redraw,
                              &rd.search_re, rd.pager_window)))) &&
@@ -2891,7 +3417,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
 
           while ((((new_topline + C_SkipQuotedOffset) < rd.last_line) ||
                   (0 == (dretval = display_line(
-                             rd.fp, &rd.last_pos, &rd.line_info, new_topline, &rd.last_line,
+                             rd.fp, &rd.last_pos, &rd.line_info, &rd.layout, new_topline, &rd.last_line,
                              &rd.max_line, MUTT_TYPES | (flags & MUTT_PAGER_NOWRAP),
                              &rd.quote_list, &rd.q_level, &rd.force_redraw,
                              &rd.search_re, rd.pager_window)))) &&
@@ -2914,7 +3440,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
         {
           int line_num = rd.curline;
           /* make sure the types are defined to the end of file */
-          while (display_line(rd.fp, &rd.last_pos, &rd.line_info, line_num, &rd.last_line,
+          while (display_line(rd.fp, &rd.last_pos, &rd.line_info, &rd.layout, line_num, &rd.last_line,
                               &rd.max_line, rd.has_types | (flags & MUTT_PAGER_NOWRAP),
                               &rd.quote_list, &rd.q_level, &rd.force_redraw,
                               &rd.search_re, rd.pager_window) == 0)
@@ -3090,11 +3616,24 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
         break;
 
       case OP_ENTER_COMMAND:
+      {
         old_PagerIndexLines = C_PagerIndexLines;
+        const bool old_HeaderColorPartial = C_HeaderColorPartial;
+        const struct Regex *old_QuoteRegex = C_QuoteRegex;
+        const struct Regex *old_Smileys = C_Smileys;
+        OptPagerRecolor = false;
 
         mutt_enter_command();
         pager_menu->redraw = REDRAW_FULL;
 
+        /* The lines need classifying again at the next reflow */
+        if (OptPagerRecolor || (old_HeaderColorPartial != C_HeaderColorPartial) ||
+            (old_QuoteRegex != C_QuoteRegex) || (old_Smileys != C_Smileys))
+        {
+          rd.layout.stale = true;
+        }
+        OptPagerRecolor = false;
+
         if (OptNeedResort)
         {
           OptNeedResort = false;
@@ -3118,6 +3657,7 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
 
         ch = 0;
         break;
+      }
 
       case OP_FLAG_MESSAGE:
         CHECK_MODE(IsEmail(extra));
@@ -3562,6 +4102,8 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
     }
   }
 
+  layout_free(&rd.layout);
+  search_index_free(&rd.search_index);
   cleanup_quote(&rd.quote_list);
 
   for (size_t i = 0; i < rd.max_line; i++)
@@ -26,6 +26,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/types.h>
 
 /* These Config Variables are only used in pager.c */
 extern bool          C_AllowAnsi;
@@ -59,16 +60,33 @@ typedef uint16_t PagerFlags;              ///< Flags for mutt_pager(), e.g. #MUT
 
 #define MUTT_DISPLAYFLAGS (MUTT_SHOW | MUTT_PAGER_NSKIP | MUTT_PAGER_MARKER | MUTT_PAGER_LOGS)
 
+/**
+ * struct PagerStream - A message that is still being decoded
+ *
+ * The decoder writes to a pipe.  Whole lines are copied from it into the file
+ * the pager is reading, while the pager waits for keys.
+ */
+struct PagerStream
+{
+  pid_t pid;              ///< Process decoding the message, or -1 when finished
+  int fd;                 ///< Read end of the pipe, or -1 at EOF
+  FILE *fp;               ///< File the pager is reading
+  struct Buffer *partial; ///< Start of a line whose newline hasn't arrived yet
+  int lines;              ///< Number of lines written so far
+  bool changed;           ///< More of the message has been written
+};
+
 /**
  * struct Pager - An email being displayed
  */
 struct Pager
 {
-  struct Context *ctx;    /**< current mailbox */
-  struct Email *email;    /**< current message */
-  struct Body *body;      /**< current attachment */
-  FILE *fp;               /**< source stream */
-  struct AttachCtx *actx; /**< attachment information */
+  struct Context *ctx;         /**< current mailbox */
+  struct Email *email;         /**< current message */
+  struct Body *body;           /**< current attachment */
+  FILE *fp;                    /**< source stream */
+  struct AttachCtx *actx;      /**< attachment information */
+  struct PagerStream *stream;  /**< message still being decoded */
 };
 
 int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct Pager *extra);
@@ -202,6 +202,43 @@ static struct PatternHead *SearchPattern = NULL; /**< current search pattern */
 static char LastSearch[256] = { 0 };      /**< last pattern searched for */
 static char LastSearchExpn[1024] = { 0 }; /**< expanded version of LastSearch */
 
+/**
+ * is_literal_search - Can a regex be matched as a simple string?
+ * @param op  Pattern operation, e.g. #MUTT_PAT_BODY
+ * @param str Regex
+ * @retval true The regex is a plain, lower-case, ASCII string
+ *
+ * A lower-case regex ignores case, so if it has no special characters it
+ * matches exactly the same as a case-insensitive substring search.  The
+ * substring is cheaper to match and, for IMAP, the server can do the search
+ * without NeoMutt downloading every message.
+ */
+static bool is_literal_search(int op, const char *str)
+{
+  switch (op)
+  {
+    case MUTT_PAT_BODY:
+    case MUTT_PAT_WHOLE_MSG:
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+      break;
+    default:
+      return false;
+  }
+
+  for (; *str; str++)
+  {
+    if (((unsigned char) *str >= 0x80) || isupper((unsigned char) *str) ||
+        strchr("\\.^$*+?()[]{}|", *str))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * eat_regex - Parse a regex - Implements ::pattern_eat_t
  */
@@ -230,6 +267,13 @@ static bool eat_regex(struct Pattern *pat, int flags, struct Buffer *s, struct B
     pat->ign_case = mutt_mb_is_lower(buf.data);
     FREE(&buf.data);
   }
+  else if (!pat->groupmatch && is_literal_search(pat->op, buf.data))
+  {
+    pat->stringmatch = true;
+    pat->ign_case = true;
+    pat->p.str = mutt_str_strdup(buf.data);
+    FREE(&buf.data);
+  }
   else if (pat->groupmatch)
   {
     pat->p.group = mutt_pattern_group(buf.data);
@@ -2005,6 +2049,12 @@ static int is_pattern_cache_set(int cache_entry)
 int mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
                       struct Mailbox *m, struct Email *e, struct PatternCache *cache)
 {
+#ifdef USE_IMAP
+  /* IMAP search sets e->matched at search compile time */
+  if (pat->isserver && m && (m->magic == MUTT_IMAP))
+    return e->matched;
+#endif
+
   switch (pat->op)
   {
     case MUTT_PAT_AND:
@@ -2058,22 +2108,14 @@ int mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
        * This is also the case when message scoring.  */
       if (!m)
         return 0;
-#ifdef USE_IMAP
-      /* IMAP search sets e->matched at search compile time */
-      if ((m->magic == MUTT_IMAP) && pat->stringmatch)
-        return e->matched;
-#endif
       return pat->not^msg_search(m, pat, e->msgno);
     case MUTT_PAT_SERVERSEARCH:
 #ifdef USE_IMAP
       if (!m)
         return 0;
+      /* only the server can do this, see imap_search() */
       if (m->magic == MUTT_IMAP)
-      {
-        if (pat->stringmatch)
-          return e->matched;
         return 0;
-      }
       mutt_error(_("error: server custom search only supported with IMAP"));
       return 0;
 #else
@@ -55,6 +55,7 @@ struct Pattern
   bool isalias : 1;
   bool dynamic : 1;  ///< evaluate date ranges at run time
   bool ismulti : 1; /**< multiple case (only for I pattern now) */
+  bool isserver : 1; ///< evaluated by the server, see imap_search()
   int min;
   int max;
   SLIST_ENTRY(Pattern) entries;
@@ -65,6 +65,9 @@
 #include "send.h"
 #include "sendlib.h"
 #include "state.h"
+#ifdef USE_IMAP
+#include "imap/imap.h"
+#endif
 #ifdef ENABLE_NLS
 #include <libintl.h>
 #endif
@@ -374,6 +377,8 @@ const char *attach_format_str(char *buf, size_t buflen, size_t col, int cols,
         stat(aptr->content->filename, &st);
         l = st.st_size;
       }
+      else if (aptr->content->remote_length != 0)
+        l = aptr->content->remote_length;
       else
         l = aptr->content->length;
 
@@ -1050,6 +1055,185 @@ static void recvattach_edit_content_type(struct AttachCtx *actx,
   mutt_update_recvattach_menu(actx, menu, true);
 }
 
+/**
+ * recvattach_is_partial - Were any attachments left out of the message?
+ * @param actx Attachment context
+ * @retval true Some attachments haven't been downloaded
+ *
+ * Large attachments of an IMAP message may not have been downloaded when it
+ * was displayed, see $imap_partial_fetch.
+ */
+static bool recvattach_is_partial(struct AttachCtx *actx)
+{
+#ifdef USE_IMAP
+  struct Mailbox *m = Context ? Context->mailbox : NULL;
+  if (!m || (m->magic != MUTT_IMAP))
+    return false;
+
+  for (int i = 0; i < actx->idxlen; i++)
+  {
+    struct AttachPtr *ap = actx->idx[i];
+    if (!ap->decrypted && imap_part_deferred(m, actx->email, ap->content))
+      return true;
+  }
+#endif
+  return false;
+}
+
+/**
+ * recvattach_fetch_parts - Download single attachments that were left out
+ * @param actx Attachment context
+ * @param menu Menu listing Attachments
+ * @param tag  If true, fetch the tagged attachments, otherwise the current one
+ * @retval true  The attachments are available
+ * @retval false Failure, or the whole message is needed
+ *
+ * An attachment is read from a single file, so a multipart whose parts were
+ * left out can't be fixed up this way.
+ */
+static bool recvattach_fetch_parts(struct AttachCtx *actx, struct Menu *menu, bool tag)
+{
+#ifdef USE_IMAP
+  struct Mailbox *m = Context ? Context->mailbox : NULL;
+  if (!m || (m->magic != MUTT_IMAP))
+    return true;
+
+  int level = -1; /* inside a chosen attachment at this level */
+  for (int i = 0; i < actx->idxlen; i++)
+  {
+    struct AttachPtr *ap = actx->idx[i];
+    if ((level >= 0) && (ap->level <= level))
+      level = -1;
+    bool chosen = (level < 0) && (tag ? ap->content->tagged : (ap == CUR_ATTACH));
+    if (chosen)
+      level = ap->level;
+    if ((level < 0) || ap->decrypted || !imap_part_deferred(m, actx->email, ap->content))
+      continue;
+    if (!chosen)
+      return false;
+    if (ap->fp != actx->fp_root)
+      continue; /* already fetched */
+
+    FILE *fp = mutt_file_mkstemp();
+    if (!fp)
+      return false;
+
+    if (imap_fetch_part(m, actx->email, ap->content, fp) < 0)
+    {
+      mutt_file_fclose(&fp);
+      return false;
+    }
+    mutt_actx_add_fp(actx, fp);
+    ap->fp = fp;
+  }
+#endif
+  return true;
+}
+
+/**
+ * recvattach_fetch_message - Download the whole of a message
+ * @param actx Attachment context
+ * @param menu Menu listing Attachments
+ * @param msg  Partial copy of the message, replaced by the whole message
+ * @retval true Success
+ *
+ * imap_msg_open() moves the existing MIME parts to the whole message, so the
+ * attachments only need to be pointed at the new file.
+ */
+static bool recvattach_fetch_message(struct AttachCtx *actx, struct Menu *menu,
+                                     struct Message **msg)
+{
+  struct Mailbox *m = Context->mailbox;
+  struct Email *e = actx->email;
+  struct Body *parts = e->content->parts;
+
+  struct Message *msg_whole = mx_msg_open(m, e->msgno);
+  if (!msg_whole)
+  {
+    mutt_error(_("Could not fetch the attachment"));
+    return false;
+  }
+
+  if (e->content->parts == parts)
+  {
+    for (int i = 0; i < actx->idxlen; i++)
+      if (!actx->idx[i]->decrypted)
+        actx->idx[i]->fp = msg_whole->fp;
+    actx->fp_root = msg_whole->fp;
+  }
+  else
+  {
+    /* The MIME structure changed, the old parts have been freed */
+    for (int i = 0; i < actx->idxlen; i++)
+      actx->idx[i]->content = NULL;
+    mutt_actx_free_entries(actx);
+    actx->fp_root = msg_whole->fp;
+    mutt_update_recvattach_menu(actx, menu, true);
+  }
+
+  mx_msg_close(m, msg);
+  *msg = msg_whole;
+  return true;
+}
+
+/**
+ * recvattach_fetch_deferred - Download the attachments an operation needs
+ * @param actx Attachment context
+ * @param menu Menu listing Attachments
+ * @param msg  Message, replaced if the whole of it has to be fetched
+ * @param op   Operation about to be performed, e.g. OP_SAVE
+ * @retval true  The operation can go ahead
+ * @retval false Failure
+ *
+ * Viewing, saving, piping or printing single attachments fetches just those.
+ * Anything else that reads the attachments, e.g. a reply that includes them,
+ * fetches the whole message.
+ */
+static bool recvattach_fetch_deferred(struct AttachCtx *actx, struct Menu *menu,
+                                      struct Message **msg, int op)
+{
+  if (!recvattach_is_partial(actx))
+    return true;
+
+  switch (op)
+  {
+    case OP_ATTACH_VIEW_MAILCAP:
+    case OP_ATTACH_VIEW_TEXT:
+    case OP_DISPLAY_HEADERS:
+    case OP_VIEW_ATTACH:
+      if (recvattach_fetch_parts(actx, menu, false))
+        return true;
+      break;
+
+    case OP_CHECK_TRADITIONAL:
+    case OP_EXTRACT_KEYS:
+    case OP_PIPE:
+    case OP_PRINT:
+    case OP_SAVE:
+      if (recvattach_fetch_parts(actx, menu, menu->tagprefix))
+        return true;
+      break;
+
+    case OP_BOUNCE_MESSAGE:
+    case OP_COMPOSE_TO_SENDER:
+    case OP_EDIT_TYPE:
+    case OP_FOLLOWUP:
+    case OP_FORWARD_MESSAGE:
+    case OP_FORWARD_TO_GROUP:
+    case OP_GROUP_CHAT_REPLY:
+    case OP_GROUP_REPLY:
+    case OP_LIST_REPLY:
+    case OP_REPLY:
+    case OP_RESEND:
+      break;
+
+    default:
+      return true;
+  }
+
+  return recvattach_fetch_message(actx, menu, msg);
+}
+
 /**
  * mutt_attach_display_loop - Event loop for the Attachment menu
  * @param menu Menu listing Attachments
@@ -1071,6 +1255,9 @@ int mutt_attach_display_loop(struct Menu *menu, int op, struct Email *e,
         /* fallthrough */
 
       case OP_VIEW_ATTACH:
+        /* The whole message is fetched by mutt_view_attachments() */
+        if (recv && !recvattach_fetch_parts(actx, menu, false))
+          return OP_VIEW_ATTACH;
         op = mutt_view_attachment(CUR_ATTACH->fp, CUR_ATTACH->content,
                                   MUTT_VA_REGULAR, e, actx);
         break;
@@ -1096,6 +1283,8 @@ int mutt_attach_display_loop(struct Menu *menu, int op, struct Email *e,
           op = OP_NULL;
         break;
       case OP_EDIT_TYPE:
+        if (recv && recvattach_is_partial(actx))
+          return op;
         /* when we edit the content-type, we should redisplay the attachment
          * immediately */
         mutt_edit_content_type(e, CUR_ATTACH->content, CUR_ATTACH->fp);
@@ -1334,11 +1523,16 @@ void mutt_view_attachments(struct Email *e)
   struct Mailbox *m = Context ? Context->mailbox : NULL;
 
   /* make sure we have parsed this message */
+  OptPartialFetch = true;
   mutt_parse_mime_message(m, e);
+  OptPartialFetch = false;
 
   mutt_message_hook(m, e, MUTT_MESSAGE_HOOK);
 
+  /* large attachments will be fetched when they're used */
+  OptPartialFetch = true;
   struct Message *msg = mx_msg_open(m, e->msgno);
+  OptPartialFetch = false;
   if (!msg)
     return;
 
@@ -1360,6 +1554,11 @@ void mutt_view_attachments(struct Email *e)
       op = mutt_menu_loop(menu);
     if (!Context)
       return;
+    if (!recvattach_fetch_deferred(actx, menu, &msg, op))
+    {
+      op = OP_NULL;
+      continue;
+    }
     switch (op)
     {
       case OP_ATTACH_VIEW_MAILCAP:
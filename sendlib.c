@@ -93,6 +93,26 @@ bool C_UseEnvelopeFrom; ///< Config: Set the envelope sender of the message
 bool C_UserAgent;       ///< Config: Add a 'User-Agent' head to outgoing mail
 short C_WrapHeaders;    ///< Config: Width to wrap headers in outgoing messages
 
+/**
+ * qp_literal_span - Count the characters that can be copied as-is
+ * @param buf Characters to encode
+ * @param len Length of buf
+ * @retval num Length of the leading run of literal characters
+ *
+ * Literal characters are the printable ones, tab and space, except '='.
+ */
+static size_t qp_literal_span(const char *buf, size_t len)
+{
+  size_t i = 0;
+  for (; i < len; i++)
+  {
+    const unsigned char c = buf[i];
+    if (((c < 32) && (c != '\t')) || (c > 126) || (c == '='))
+      break;
+  }
+  return i;
+}
+
 /**
  * encode_quoted - Encode text as quoted printable
  * @param fc     Cursor for converting a file's encoding
@@ -103,9 +123,33 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
 {
   int c, linelen = 0;
   char line[77], savechar;
+  char buf[8192];
+  size_t pos = 0, buflen = 0;
 
-  while ((c = mutt_ch_fgetconv(fc)) != EOF)
+  while (true)
   {
+    if (pos == buflen)
+    {
+      buflen = mutt_ch_fgetconv_read(fc, buf, sizeof(buf));
+      pos = 0;
+      if (buflen == 0)
+        break;
+    }
+
+    /* Once past the "From " and "." checks, copy a run of literal characters
+     * in one go.  The last column is left to the code below, which wraps.  */
+    if ((linelen > 4) && (linelen < 75))
+    {
+      size_t run = qp_literal_span(buf + pos, MIN(buflen - pos, (size_t)(75 - linelen)));
+      memcpy(line + linelen, buf + pos, run);
+      linelen += run;
+      pos += run;
+      if (pos == buflen)
+        continue;
+    }
+
+    c = (unsigned char) buf[pos++];
+
     /* Wrap the line if needed. */
     if ((linelen == 76) && ((istext && (c != '\n')) || !istext))
     {
@@ -227,104 +271,84 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
   }
 }
 
-/**
- * struct B64Context - Cursor for the Base64 conversion
- */
-struct B64Context
-{
-  char buffer[3];
-  short size;
-  short linelen;
-};
-
-/**
- * b64_init - Set up the base64 conversion
- * @param bctx Cursor for the base64 conversion
- * @retval 0 Always
- */
-static int b64_init(struct B64Context *bctx)
-{
-  memset(bctx->buffer, '\0', sizeof(bctx->buffer));
-  bctx->size = 0;
-  bctx->linelen = 0;
-
-  return 0;
-}
-
-/**
- * b64_flush - Save the bytes to the file
- * @param bctx   Cursor for the base64 conversion
- * @param fp_out File to save the output
- */
-static void b64_flush(struct B64Context *bctx, FILE *fp_out)
-{
-  /* for some reasons, mutt_b64_encode expects the
-   * output buffer to be larger than 10B */
-  char encoded[11];
-  size_t ret;
-
-  if (bctx->size == 0)
-    return;
-
-  if (bctx->linelen >= 72)
-  {
-    fputc('\n', fp_out);
-    bctx->linelen = 0;
-  }
-
-  /* ret should always be equal to 4 here, because bctx->size
-   * is a value between 1 and 3 (included), but let's not hardcode it
-   * and prefer the return value of the function */
-  ret = mutt_b64_encode(bctx->buffer, bctx->size, encoded, sizeof(encoded));
-  for (size_t i = 0; i < ret; i++)
-  {
-    fputc(encoded[i], fp_out);
-    bctx->linelen++;
-  }
-
-  bctx->size = 0;
-}
-
-/**
- * b64_putc - Base64-encode one character
- * @param bctx   Cursor for the base64 conversion
- * @param c      Character to encode
- * @param fp_out File to save the output
- */
-static void b64_putc(struct B64Context *bctx, char c, FILE *fp_out)
-{
-  if (bctx->size == 3)
-    b64_flush(bctx, fp_out);
-
-  bctx->buffer[bctx->size++] = c;
-}
+/* Base64 output lines are 72 characters, which encode 54 bytes of input */
+#define B64_LINE_IN 54
 
 /**
  * encode_base64 - Base64-encode some data
  * @param fc     Cursor for converting a file's encoding
  * @param fp_out File to store the result
  * @param istext Is the input text?
+ *
+ * The input is encoded a line at a time and written out a block at a time.
  */
 static void encode_base64(struct FgetConv *fc, FILE *fp_out, int istext)
 {
-  struct B64Context bctx;
-  int ch, ch1 = EOF;
+  char bufi[B64_LINE_IN * 128];
+  /* unencoded remainder of the last line, plus bufi with CRs added */
+  char bufx[B64_LINE_IN + sizeof(bufi) * 2];
+  char bufo[(sizeof(bufx) / B64_LINE_IN) * 73 + 16];
+  size_t pending = 0, done, olen, n;
+  int ch1 = EOF;
+  bool first = true;
 
-  b64_init(&bctx);
-
-  while ((ch = mutt_ch_fgetconv(fc)) != EOF)
+  while ((n = mutt_ch_fgetconv_read(fc, bufi, sizeof(bufi))) != 0)
   {
     if (SigInt == 1)
     {
       SigInt = 0;
       return;
     }
-    if (istext && (ch == '\n') && (ch1 != '\r'))
-      b64_putc(&bctx, '\r', fp_out);
-    b64_putc(&bctx, ch, fp_out);
-    ch1 = ch;
+
+    if (istext)
+    {
+      const char *p = bufi;
+      const char *end = bufi + n;
+      while (p < end)
+      {
+        const char *nl = memchr(p, '\n', end - p);
+        if (!nl)
+        {
+          memcpy(bufx + pending, p, end - p);
+          pending += end - p;
+          break;
+        }
+        memcpy(bufx + pending, p, nl - p);
+        pending += nl - p;
+        if (((nl > bufi) ? nl[-1] : ch1) != '\r')
+          bufx[pending++] = '\r';
+        bufx[pending++] = '\n';
+        p = nl + 1;
+      }
+      ch1 = bufi[n - 1];
+    }
+    else
+    {
+      memcpy(bufx + pending, bufi, n);
+      pending += n;
+    }
+
+    olen = 0;
+    for (done = 0; (pending - done) >= B64_LINE_IN; done += B64_LINE_IN)
+    {
+      if (!first)
+        bufo[olen++] = '\n';
+      first = false;
+      olen += mutt_b64_encode(bufx + done, B64_LINE_IN, bufo + olen, sizeof(bufo) - olen);
+    }
+    fwrite(bufo, 1, olen, fp_out);
+
+    pending -= done;
+    memmove(bufx, bufx + done, pending);
+  }
+
+  if (pending != 0)
+  {
+    if (!first)
+      fputc('\n', fp_out);
+    mutt_b64_encode(bufx, pending, bufo, sizeof(bufo));
+    fputs(bufo, fp_out);
   }
-  b64_flush(&bctx, fp_out);
   fputc('\n', fp_out);
 }
 
@@ -335,16 +359,17 @@ static void encode_base64(struct FgetConv *fc, FILE *fp_out, int istext)
  */
 static void encode_8bit(struct FgetConv *fc, FILE *fp_out)
 {
-  int ch;
+  char buf[8192];
+  size_t n;
 
-  while ((ch = mutt_ch_fgetconv(fc)) != EOF)
+  while ((n = mutt_ch_fgetconv_read(fc, buf, sizeof(buf))) != 0)
   {
     if (SigInt == 1)
     {
       SigInt = 0;
       return;
     }
-    fputc(ch, fp_out);
+    fwrite(buf, 1, n, fp_out);
   }
 }
 
@@ -608,6 +633,28 @@ struct ContentState
   bool was_cr;
 };
 
+/**
+ * is_printable_word - Are eight bytes all printable ASCII?
+ * @param buf Bytes to test
+ * @retval true All eight bytes are in the range ' ' to '~'
+ */
+static bool is_printable_word(const char *buf)
+{
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t highs = 0x8080808080808080ULL;
+  uint64_t w;
+
+  memcpy(&w, buf, sizeof(w));
+  if (w & highs)
+    return false;
+  /* a byte below ' ' */
+  if ((w - ones * ' ') & ~w & highs)
+    return false;
+  /* a DEL byte */
+  w ^= ones * 0x7f;
+  return !((w - ones) & ~w & highs);
+}
+
 /**
  * update_content_info - Cache some info about an email
  * @param info   Info about an Attachment
@@ -636,6 +683,21 @@ static void update_content_info(struct Content *info, struct ContentState *s,
 
   for (; buflen; buf++, buflen--)
   {
+    /* Mid-line, eight printable characters that don't end in a space only
+     * change the counts; skip the per-character checks for them.  */
+    while (!was_cr && (linelen >= 4) && (buflen >= 8) && (buf[7] != ' ') &&
+           is_printable_word(buf))
+    {
+      linelen += 8;
+      info->ascii += 8;
+      whitespace = 0;
+      dot = false;
+      buf += 8;
+      buflen -= 8;
+    }
+    if (buflen == 0)
+      break;
+
     char ch = *buf;
 
     if (was_cr)
@@ -767,7 +829,7 @@ static void update_content_info(struct Content *info, struct ContentState *s,
 static size_t convert_file_to(FILE *fp, const char *fromcode, int ncodes,
                               const char **tocodes, int *tocode, struct Content *info)
 {
-  char bufi[256], bufu[512], bufo[4 * sizeof(bufi)];
+  char bufi[4096], bufu[2 * sizeof(bufi)], bufo[4 * sizeof(bufi)];
   size_t ret;
 
   const iconv_t cd1 = mutt_ch_iconv_open("utf-8", fromcode, 0);
@@ -885,9 +947,9 @@ static size_t convert_file_to(FILE *fp, const char *fromcode, int ncodes,
 
   for (int i = 0; i < ncodes; i++)
     if (cd[i] != (iconv_t)(-1))
-      iconv_close(cd[i]);
+      mutt_ch_iconv_close(cd[i]);
 
-  iconv_close(cd1);
+  mutt_ch_iconv_close(cd1);
   FREE(&cd);
   FREE(&infos);
   FREE(&score);
@@ -1003,7 +1065,7 @@ struct Content *mutt_get_content_info(const char *fname, struct Body *b)
   FILE *fp = NULL;
   char *fromcode = NULL;
   char *tocode = NULL;
-  char buf[100];
+  char buf[8192];
   size_t r;
 
   struct stat sb;
@@ -74,11 +74,27 @@ struct SbEntry
   char box[256];           /**< formatted mailbox name */
   struct Mailbox *mailbox; /**< Mailbox this represents */
   bool is_hidden;          /**< Don't show, e.g. $sidebar_new_mail_only */
+  bool is_open;            /**< Mailbox is open in the Context */
+  bool has_new;            /**< Cached: Mailbox::has_new */
+  int msg_count;           /**< Cached: Mailbox::msg_count */
+  int msg_unread;          /**< Cached: Mailbox::msg_unread */
+  int msg_flagged;         /**< Cached: Mailbox::msg_flagged */
+  int msg_deleted;         /**< Cached: Mailbox::msg_deleted, if open */
+  int msg_tagged;          /**< Cached: Mailbox::msg_tagged, if open */
+  int vcount;              /**< Cached: Mailbox::vcount, if open */
+  char *desc;              /**< Cached: Mailbox::desc */
+  char *path;              /**< Cached: Mailbox::pathbuf */
+  bool resort;             /**< Counts changed since the last sort */
+  bool dirty;              /**< Counts changed since the row was formatted */
+  int row_gen;             /**< Value of RowGeneration when the row was formatted */
+  int row_width;           /**< Width the row was formatted for */
+  char row[256];           /**< Formatted sidebar row */
 };
 
 static int EntryCount = 0;
 static int EntryLen = 0;
 static struct SbEntry **Entries = NULL;
+static int RowGeneration = 0; /**< Bumped when a config change invalidates all the rows */
 
 static int TopIndex = -1; /**< First mailbox visible in sidebar */
 static int OpnIndex = -1; /**< Current (open) mailbox */
@@ -342,6 +358,59 @@ static int cb_qsort_sbe(const void *a, const void *b)
   return rc;
 }
 
+/**
+ * update_entry_stats - Refresh the cached counts of a sidebar entry
+ * @param sbe Sidebar entry
+ *
+ * If the counts, the description or the path, that are displayed or sorted on,
+ * have changed, mark the entry for resorting and reformatting.
+ */
+static void update_entry_stats(struct SbEntry *sbe)
+{
+  struct Mailbox *m = sbe->mailbox;
+  struct Mailbox *m_ctx = Context ? Context->mailbox : NULL;
+
+  bool is_open = m_ctx && (m_ctx->realpath[0] != '\0') &&
+                 (mutt_str_strcmp(m->realpath, m_ctx->realpath) == 0);
+  if (is_open)
+  {
+    m->msg_unread = m_ctx->msg_unread;
+    m->msg_count = m_ctx->msg_count;
+    m->msg_flagged = m_ctx->msg_flagged;
+  }
+
+  int msg_deleted = is_open ? m_ctx->msg_deleted : 0;
+  int msg_tagged = is_open ? m_ctx->msg_tagged : 0;
+  int vcount = is_open ? m_ctx->vcount : 0;
+
+  if ((sbe->msg_count != m->msg_count) || (sbe->msg_unread != m->msg_unread) ||
+      (sbe->msg_flagged != m->msg_flagged) || (mutt_str_strcmp(sbe->desc, m->desc) != 0) ||
+      (mutt_str_strcmp(sbe->path, mutt_b2s(m->pathbuf)) != 0))
+  {
+    sbe->resort = true;
+  }
+  else if ((sbe->is_open == is_open) && (sbe->has_new == m->has_new) &&
+           (sbe->msg_deleted == msg_deleted) && (sbe->msg_tagged == msg_tagged) &&
+           (sbe->vcount == vcount))
+  {
+    return;
+  }
+
+  sbe->is_open = is_open;
+  sbe->has_new = m->has_new;
+  sbe->msg_count = m->msg_count;
+  sbe->msg_unread = m->msg_unread;
+  sbe->msg_flagged = m->msg_flagged;
+  sbe->msg_deleted = msg_deleted;
+  sbe->msg_tagged = msg_tagged;
+  sbe->vcount = vcount;
+  if (mutt_str_strcmp(sbe->desc, m->desc) != 0)
+    mutt_str_replace(&sbe->desc, m->desc);
+  if (mutt_str_strcmp(sbe->path, mutt_b2s(m->pathbuf)) != 0)
+    mutt_str_replace(&sbe->path, mutt_b2s(m->pathbuf));
+  sbe->dirty = true;
+}
+
 /**
  * update_entries_visibility - Should a sidebar_entry be displayed in the sidebar
  *
@@ -431,6 +500,60 @@ static void unsort_entries(void)
   }
 }
 
+/**
+ * resort_entries - Move the changed entries back into sorted order
+ *
+ * The entries whose counts haven't changed are still in order, so take the
+ * changed entries out and insert them again, using a binary search.  If most
+ * of the entries have changed, it's quicker to sort the lot.
+ */
+static void resort_entries(void)
+{
+  int num_changed = 0;
+  for (int i = 0; i < EntryCount; i++)
+    if (Entries[i]->resort)
+      num_changed++;
+
+  if (num_changed == 0)
+    return;
+
+  if (num_changed > (EntryCount / 8))
+  {
+    qsort(Entries, EntryCount, sizeof(*Entries), cb_qsort_sbe);
+    return;
+  }
+
+  struct SbEntry **changed = mutt_mem_calloc(num_changed, sizeof(*changed));
+  int num_sorted = 0;
+  num_changed = 0;
+  for (int i = 0; i < EntryCount; i++)
+  {
+    if (Entries[i]->resort)
+      changed[num_changed++] = Entries[i];
+    else
+      Entries[num_sorted++] = Entries[i];
+  }
+
+  for (int i = 0; i < num_changed; i++)
+  {
+    int lo = 0;
+    int hi = num_sorted;
+    while (lo < hi)
+    {
+      int mid = lo + ((hi - lo) / 2);
+      if (cb_qsort_sbe(&changed[i], &Entries[mid]) < 0)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    memmove(Entries + lo + 1, Entries + lo, (num_sorted - lo) * sizeof(*Entries));
+    Entries[lo] = changed[i];
+    num_sorted++;
+  }
+
+  FREE(&changed);
+}
+
 /**
  * sort_entries - Sort Entries array
  *
@@ -446,9 +569,17 @@ static void sort_entries(void)
 
   /* These are the only sort methods we understand */
   if ((ssm == SORT_COUNT) || (ssm == SORT_UNREAD) || (ssm == SORT_FLAGGED) || (ssm == SORT_PATH))
-    qsort(Entries, EntryCount, sizeof(*Entries), cb_qsort_sbe);
+  {
+    if (C_SidebarSortMethod != PreviousSort)
+      qsort(Entries, EntryCount, sizeof(*Entries), cb_qsort_sbe);
+    else
+      resort_entries();
+  }
   else if ((ssm == SORT_ORDER) && (C_SidebarSortMethod != PreviousSort))
     unsort_entries();
+
+  for (int i = 0; i < EntryCount; i++)
+    Entries[i]->resort = false;
 }
 
 /**
@@ -612,8 +743,9 @@ static int select_page_up(void)
  * Before painting the sidebar, we determine which are visible, sort
  * them and set up our page pointers.
  *
- * This is a lot of work to do each refresh, but there are many things that
- * can change outside of the sidebar that we don't hear about.
+ * Many things can change outside of the sidebar that we don't hear about, so
+ * the counts of every Mailbox are compared with the cached copies.  Only the
+ * entries that have changed will be resorted, or reformatted.
  */
 static bool prepare_sidebar(int page_size)
 {
@@ -623,6 +755,9 @@ static bool prepare_sidebar(int page_size)
   const struct SbEntry *opn_entry = (OpnIndex >= 0) ? Entries[OpnIndex] : NULL;
   const struct SbEntry *hil_entry = (HilIndex >= 0) ? Entries[HilIndex] : NULL;
 
+  for (int i = 0; i < EntryCount; i++)
+    update_entry_stats(Entries[i]);
+
   update_entries_visibility();
   sort_entries();
 
@@ -796,6 +931,102 @@ static void fill_empty_space(int first_row, int num_rows, int div_width, int num
   }
 }
 
+/**
+ * format_entry - Format the sidebar row of a Mailbox
+ * @param sbe   Sidebar entry
+ * @param width Desired width in screen cells
+ *
+ * The entry's name is abbreviated and indented according to the config, then
+ * the row is formatted using $sidebar_format and cached in the entry.
+ */
+static void format_entry(struct SbEntry *sbe, int width)
+{
+  struct Mailbox *m = sbe->mailbox;
+
+  /* compute length of C_Folder without trailing separator */
+  size_t maildirlen = mutt_str_strlen(C_Folder);
+  if (maildirlen && C_SidebarDelimChars &&
+      strchr(C_SidebarDelimChars, C_Folder[maildirlen - 1]))
+    maildirlen--;
+
+  /* check whether C_Folder is a prefix of the current folder's path */
+  bool maildir_is_prefix = false;
+  if ((mutt_buffer_len(m->pathbuf) > maildirlen) &&
+      (mutt_str_strncmp(C_Folder, mutt_b2s(m->pathbuf), maildirlen) == 0) && C_SidebarDelimChars &&
+      strchr(C_SidebarDelimChars, mutt_b2s(m->pathbuf)[maildirlen]))
+  {
+    maildir_is_prefix = true;
+  }
+
+  /* calculate depth of current folder and generate its display name with indented spaces */
+  int sidebar_folder_depth = 0;
+  const char *sidebar_folder_name = NULL;
+  struct Buffer *short_folder_name = NULL;
+  if (C_SidebarShortPath)
+  {
+    /* disregard a trailing separator, so strlen() - 2 */
+    sidebar_folder_name = mutt_b2s(m->pathbuf);
+    for (int i = mutt_str_strlen(sidebar_folder_name) - 2; i >= 0; i--)
+    {
+      if (C_SidebarDelimChars && strchr(C_SidebarDelimChars, sidebar_folder_name[i]))
+      {
+        sidebar_folder_name += (i + 1);
+        break;
+      }
+    }
+  }
+  else if ((C_SidebarComponentDepth > 0) && C_SidebarDelimChars)
+  {
+    sidebar_folder_name = mutt_b2s(m->pathbuf) + maildir_is_prefix * (maildirlen + 1);
+    for (int i = 0; i < C_SidebarComponentDepth; i++)
+    {
+      char *chars_after_delim = strpbrk(sidebar_folder_name, C_SidebarDelimChars);
+      if (!chars_after_delim)
+        break;
+      else
+        sidebar_folder_name = chars_after_delim + 1;
+    }
+  }
+  else
+    sidebar_folder_name = mutt_b2s(m->pathbuf) + maildir_is_prefix * (maildirlen + 1);
+
+  if (m->desc)
+  {
+    sidebar_folder_name = m->desc;
+  }
+  else if (maildir_is_prefix && C_SidebarFolderIndent)
+  {
+    int lastsep = 0;
+    const char *tmp_folder_name = mutt_b2s(m->pathbuf) + maildirlen + 1;
+    int tmplen = (int) mutt_str_strlen(tmp_folder_name) - 1;
+    for (int i = 0; i < tmplen; i++)
+    {
+      if (C_SidebarDelimChars && strchr(C_SidebarDelimChars, tmp_folder_name[i]))
+      {
+        sidebar_folder_depth++;
+        lastsep = i + 1;
+      }
+    }
+    if (sidebar_folder_depth > 0)
+    {
+      if (C_SidebarShortPath)
+        tmp_folder_name += lastsep; /* basename */
+      short_folder_name = mutt_buffer_pool_get();
+      for (int i = 0; i < sidebar_folder_depth; i++)
+        mutt_buffer_addstr(short_folder_name, NONULL(C_SidebarIndentString));
+      mutt_buffer_addstr(short_folder_name, tmp_folder_name);
+      sidebar_folder_name = mutt_b2s(short_folder_name);
+    }
+  }
+
+  make_sidebar_entry(sbe->row, sizeof(sbe->row), width, sidebar_folder_name, sbe);
+  mutt_buffer_pool_release(&short_folder_name);
+
+  sbe->dirty = false;
+  sbe->row_gen = RowGeneration;
+  sbe->row_width = width;
+}
+
 /**
  * draw_sidebar - Write out a list of mailboxes, in a panel
  * @param num_rows   Height of the Sidebar
@@ -864,93 +1095,9 @@ static void draw_sidebar(int num_rows, int num_cols, int div_width)
       col = div_width;
 
     mutt_window_move(MuttSidebarWindow, row, col);
-    if (Context && (Context->mailbox->realpath[0] != '\0') &&
-        (mutt_str_strcmp(m->realpath, Context->mailbox->realpath) == 0))
-    {
-      m->msg_unread = Context->mailbox->msg_unread;
-      m->msg_count = Context->mailbox->msg_count;
-      m->msg_flagged = Context->mailbox->msg_flagged;
-    }
-
-    /* compute length of C_Folder without trailing separator */
-    size_t maildirlen = mutt_str_strlen(C_Folder);
-    if (maildirlen && C_SidebarDelimChars &&
-        strchr(C_SidebarDelimChars, C_Folder[maildirlen - 1]))
-      maildirlen--;
-
-    /* check whether C_Folder is a prefix of the current folder's path */
-    bool maildir_is_prefix = false;
-    if ((mutt_buffer_len(m->pathbuf) > maildirlen) &&
-        (mutt_str_strncmp(C_Folder, mutt_b2s(m->pathbuf), maildirlen) == 0) && C_SidebarDelimChars &&
-        strchr(C_SidebarDelimChars, mutt_b2s(m->pathbuf)[maildirlen]))
-    {
-      maildir_is_prefix = true;
-    }
-
-    /* calculate depth of current folder and generate its display name with indented spaces */
-    int sidebar_folder_depth = 0;
-    const char *sidebar_folder_name = NULL;
-    struct Buffer *short_folder_name = NULL;
-    if (C_SidebarShortPath)
-    {
-      /* disregard a trailing separator, so strlen() - 2 */
-      sidebar_folder_name = mutt_b2s(m->pathbuf);
-      for (int i = mutt_str_strlen(sidebar_folder_name) - 2; i >= 0; i--)
-      {
-        if (C_SidebarDelimChars && strchr(C_SidebarDelimChars, sidebar_folder_name[i]))
-        {
-          sidebar_folder_name += (i + 1);
-          break;
-        }
-      }
-    }
-    else if ((C_SidebarComponentDepth > 0) && C_SidebarDelimChars)
-    {
-      sidebar_folder_name = mutt_b2s(m->pathbuf) + maildir_is_prefix * (maildirlen + 1);
-      for (int i = 0; i < C_SidebarComponentDepth; i++)
-      {
-        char *chars_after_delim = strpbrk(sidebar_folder_name, C_SidebarDelimChars);
-        if (!chars_after_delim)
-          break;
-        else
-          sidebar_folder_name = chars_after_delim + 1;
-      }
-    }
-    else
-      sidebar_folder_name = mutt_b2s(m->pathbuf) + maildir_is_prefix * (maildirlen + 1);
-
-    if (m->desc)
-    {
-      sidebar_folder_name = m->desc;
-    }
-    else if (maildir_is_prefix && C_SidebarFolderIndent)
-    {
-      int lastsep = 0;
-      const char *tmp_folder_name = mutt_b2s(m->pathbuf) + maildirlen + 1;
-      int tmplen = (int) mutt_str_strlen(tmp_folder_name) - 1;
-      for (int i = 0; i < tmplen; i++)
-      {
-        if (C_SidebarDelimChars && strchr(C_SidebarDelimChars, tmp_folder_name[i]))
-        {
-          sidebar_folder_depth++;
-          lastsep = i + 1;
-        }
-      }
-      if (sidebar_folder_depth > 0)
-      {
-        if (C_SidebarShortPath)
-          tmp_folder_name += lastsep; /* basename */
-        short_folder_name = mutt_buffer_pool_get();
-        for (int i = 0; i < sidebar_folder_depth; i++)
-          mutt_buffer_addstr(short_folder_name, NONULL(C_SidebarIndentString));
-        mutt_buffer_addstr(short_folder_name, tmp_folder_name);
-        sidebar_folder_name = mutt_b2s(short_folder_name);
-      }
-    }
-    char str[256];
-    make_sidebar_entry(str, sizeof(str), w, sidebar_folder_name, entry);
-    printw("%s", str);
-    mutt_buffer_pool_release(&short_folder_name);
+    if (entry->dirty || (entry->row_gen != RowGeneration) || (entry->row_width != w))
+      format_entry(entry, w);
+    printw("%s", entry->row);
     row++;
   }
 
@@ -1121,6 +1268,8 @@ void mutt_sb_notify_mailbox(struct Mailbox *m, bool created)
     }
     Entries[EntryCount] = mutt_mem_calloc(1, sizeof(struct SbEntry));
     Entries[EntryCount]->mailbox = m;
+    Entries[EntryCount]->resort = true;
+    Entries[EntryCount]->dirty = true;
 
     if (TopIndex < 0)
       TopIndex = EntryCount;
@@ -1140,6 +1289,8 @@ void mutt_sb_notify_mailbox(struct Mailbox *m, bool created)
         break;
     if (del_index == EntryCount)
       return;
+    FREE(&Entries[del_index]->desc);
+    FREE(&Entries[del_index]->path);
     FREE(&Entries[del_index]);
     EntryCount--;
 
@@ -1160,3 +1311,16 @@ void mutt_sb_notify_mailbox(struct Mailbox *m, bool created)
 
   mutt_menu_set_current_redraw(REDRAW_SIDEBAR);
 }
+
+/**
+ * mutt_sb_observer - Listen for config changes affecting the sidebar - Implements ::cs_observer()
+ *
+ * Almost any config variable can change the look of the formatted rows, so
+ * throw them all away.
+ */
+bool mutt_sb_observer(const struct ConfigSet *cs, struct HashElem *he,
+                      const char *name, enum ConfigEvent ev)
+{
+  RowGeneration++;
+  return true;
+}
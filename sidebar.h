@@ -26,6 +26,7 @@
 #define MUTT_SIDEBAR_H
 
 #include <stdbool.h>
+#include "config/lib.h"
 
 struct Mailbox;
 
@@ -46,6 +47,7 @@ void mutt_sb_change_mailbox(int op);
 void mutt_sb_draw(void);
 struct Mailbox *mutt_sb_get_highlight(void);
 void mutt_sb_notify_mailbox(struct Mailbox *m, bool created);
+bool mutt_sb_observer(const struct ConfigSet *cs, struct HashElem *he, const char *name, enum ConfigEvent ev);
 void mutt_sb_set_open_mailbox(void);
 
 #endif /* MUTT_SIDEBAR_H */
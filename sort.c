@@ -47,6 +47,9 @@
 #include "mx.h"
 #include "nntp/nntp.h"
 #endif
+#ifdef USE_IMAP
+#include "imap/imap.h"
+#endif
 
 /* These Config Variables are only used in sort.c */
 bool C_ReverseAlias; ///< Config: Display the alias in the index, rather than the message's sender
@@ -423,8 +426,18 @@ void mutt_sort_headers(struct Context *ctx, bool init)
     return;
   }
   else
-    qsort((void *) ctx->mailbox->emails, ctx->mailbox->msg_count,
-          sizeof(struct Email *), sortfunc);
+  {
+    bool sorted = false;
+#ifdef USE_IMAP
+    /* the server may put the emails in order for us */
+    sorted = (imap_sort(ctx->mailbox, C_Sort) == 0);
+#endif
+    if (!sorted)
+    {
+      qsort((void *) ctx->mailbox->emails, ctx->mailbox->msg_count,
+            sizeof(struct Email *), sortfunc);
+    }
+  }
 
   /* adjust the virtual message numbers */
   ctx->mailbox->vcount = 0;
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * Test code for mutt_b64_decode_stream()
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <string.h>
+#include "mutt/mutt.h"
+
+static const char clear[] = "Hello, World";
+static const char encoded[] = "SGVs\nbG8s IFdv\r\ncmxk\n";
+
+void test_mutt_b64_decode_stream(void)
+{
+  // size_t mutt_b64_decode_stream(struct B64Decoder *dec, const char *in, size_t inlen, char *out);
+
+  {
+    char out[32];
+    TEST_CHECK(mutt_b64_decode_stream(NULL, "YQ==", 4, out) == 0);
+  }
+
+  {
+    struct B64Decoder dec = { 0 };
+    TEST_CHECK(mutt_b64_decode_stream(&dec, NULL, 4, "banana") == 0);
+  }
+
+  {
+    struct B64Decoder dec = { 0 };
+    char out[32];
+    TEST_CHECK(mutt_b64_decode_stream(&dec, "YQ==", 4, NULL) == 0);
+    TEST_CHECK(mutt_b64_decode_stream(&dec, "YQ==", 0, out) == 0);
+  }
+
+  {
+    /* Whole input in one block, skipping whitespace */
+    struct B64Decoder dec = { 0 };
+    char out[32] = { 0 };
+    size_t len = mutt_b64_decode_stream(&dec, encoded, strlen(encoded), out);
+    if (!TEST_CHECK(len == (sizeof(clear) - 1)))
+    {
+      TEST_MSG("Expected: %zu", sizeof(clear) - 1);
+      TEST_MSG("Actual  : %zu", len);
+    }
+    TEST_CHECK(memcmp(out, clear, sizeof(clear) - 1) == 0);
+    TEST_CHECK(dec.num == 0);
+    TEST_CHECK(!dec.done);
+  }
+
+  {
+    /* Every possible split into two blocks */
+    for (size_t split = 0; split <= strlen(encoded); split++)
+    {
+      struct B64Decoder dec = { 0 };
+      char out[32] = { 0 };
+      size_t len = mutt_b64_decode_stream(&dec, encoded, split, out);
+      len += mutt_b64_decode_stream(&dec, encoded + split, strlen(encoded) - split, out + len);
+      TEST_CASE_("split %zu", split);
+      TEST_CHECK(len == (sizeof(clear) - 1));
+      TEST_CHECK(memcmp(out, clear, sizeof(clear) - 1) == 0);
+    }
+  }
+
+  {
+    /* Padding ends the stream */
+    struct B64Decoder dec = { 0 };
+    char out[32] = { 0 };
+    static const char padded[] = "SGVsbG8=SGVsbG8=";
+    size_t len = mutt_b64_decode_stream(&dec, padded, 8, out);
+    TEST_CHECK(len == 5);
+    TEST_CHECK(dec.done);
+    TEST_CHECK(mutt_b64_decode_stream(&dec, padded + 8, 8, out + len) == 0);
+    TEST_CHECK(memcmp(out, "Hello", 5) == 0);
+  }
+
+  {
+    /* An incomplete group is kept for the next block */
+    struct B64Decoder dec = { 0 };
+    char out[32] = { 0 };
+    TEST_CHECK(mutt_b64_decode_stream(&dec, "SGV", 3, out) == 0);
+    TEST_CHECK(dec.num == 3);
+    TEST_CHECK(mutt_b64_decode_stream(&dec, "s", 1, out) == 3);
+    TEST_CHECK(memcmp(out, "Hel", 3) == 0);
+  }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * Test code for mutt_ch_cache_cleanup()
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <string.h>
+#include "mutt/mutt.h"
+
+
+void test_mutt_ch_cache_cleanup(void)
+{
+  // void mutt_ch_cache_cleanup(void);
+
+  {
+    mutt_ch_cache_cleanup();
+    TEST_CHECK_(1, "mutt_ch_cache_cleanup()");
+  }
+
+  {
+    // A handle that's in use survives the cleanup
+    iconv_t cd = mutt_ch_iconv_open("utf-8", "iso-8859-1", 0);
+    TEST_CHECK(cd != (iconv_t) -1);
+    mutt_ch_cache_cleanup();
+
+    char in[] = "caf\xe9";
+    char out[16];
+    char *ib = in;
+    char *ob = out;
+    size_t ibl = 4;
+    size_t obl = sizeof(out);
+    TEST_CHECK(iconv(cd, &ib, &ibl, &ob, &obl) == 0);
+    TEST_CHECK(((ob - out) == 5) && (memcmp(out, "caf\xc3\xa9", 5) == 0));
+    mutt_ch_iconv_close(cd);
+  }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Test code for mutt_ch_fgetconv_read()
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <string.h>
+#include "mutt/mutt.h"
+
+static size_t read_all(const char *in, const char *from, const char *to,
+                       char *out, size_t outlen, size_t step)
+{
+  FILE *fp = fmemopen((void *) in, strlen(in), "r");
+  if (!fp)
+    return 0;
+
+  struct FgetConv *fc = mutt_ch_fgetconv_open(fp, from, to, 0);
+  size_t len = 0;
+  size_t n;
+  while ((len < outlen) &&
+         (n = mutt_ch_fgetconv_read(fc, out + len, MIN(step, outlen - len))) != 0)
+  {
+    len += n;
+  }
+  mutt_ch_fgetconv_close(&fc);
+  fclose(fp);
+  return len;
+}
+
+void test_mutt_ch_fgetconv_read(void)
+{
+  // size_t mutt_ch_fgetconv_read(struct FgetConv *fc, char *buf, size_t buflen);
+
+  {
+    char buf[32];
+    TEST_CHECK(mutt_ch_fgetconv_read(NULL, buf, sizeof(buf)) == 0);
+  }
+
+  {
+    struct FgetConv fgetconv = { 0 };
+    TEST_CHECK(mutt_ch_fgetconv_read(&fgetconv, NULL, 10) == 0);
+  }
+
+  {
+    // No conversion
+    char buf[32];
+    size_t len = read_all("apple\nbanana\n", NULL, NULL, buf, sizeof(buf), 5);
+    TEST_CHECK(len == 13);
+    TEST_CHECK(memcmp(buf, "apple\nbanana\n", len) == 0);
+  }
+
+  {
+    // ASCII is copied, the rest is converted
+    char buf[32];
+    size_t len = read_all("caf\xe9 cr\xe8me\n", "iso-8859-1", "utf-8", buf,
+                          sizeof(buf), 3);
+    TEST_CHECK(len == 13);
+    TEST_CHECK(memcmp(buf, "caf\xc3\xa9 cr\xc3\xa8me\n", len) == 0);
+  }
+
+  {
+    // Valid UTF-8 is copied, invalid bytes are replaced
+    char buf[32];
+    size_t len = read_all("\xe2\x82\xac \xff!", "utf-8", "utf-8", buf, sizeof(buf), 1);
+    TEST_CHECK(len == 8);
+    TEST_CHECK(memcmp(buf, "\xe2\x82\xac \xef\xbf\xbd!", len) == 0);
+  }
+
+  {
+    // Stateful charsets are always converted
+    char buf[32];
+    size_t len = read_all("a\x1b$B!\"\x1b(Bb", "iso-2022-jp", "utf-8", buf,
+                          sizeof(buf), 32);
+    TEST_CHECK(len == 5);
+    TEST_CHECK(memcmp(buf, "a\xe3\x80\x81" "b", len) == 0);
+  }
+}
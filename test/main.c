@@ -59,6 +59,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_b64_buffer_decode)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_buffer_encode)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_decode)                                      \
+  NEOMUTT_TEST_ITEM(test_mutt_b64_decode_stream)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_encode)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_body_cmp_strict)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_body_free)                                       \
@@ -84,6 +85,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_buffer_reset)                                    \
   NEOMUTT_TEST_ITEM(test_mutt_buffer_strcpy)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_buffer_strcpy_n)                                 \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_cache_cleanup)                                \
   NEOMUTT_TEST_ITEM(test_mutt_ch_canonical_charset)                            \
   NEOMUTT_TEST_ITEM(test_mutt_ch_charset_lookup)                               \
   NEOMUTT_TEST_ITEM(test_mutt_ch_check)                                        \
@@ -95,10 +97,12 @@
   NEOMUTT_TEST_ITEM(test_mutt_ch_fgetconv)                                     \
   NEOMUTT_TEST_ITEM(test_mutt_ch_fgetconv_close)                               \
   NEOMUTT_TEST_ITEM(test_mutt_ch_fgetconv_open)                                \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_fgetconv_read)                                \
   NEOMUTT_TEST_ITEM(test_mutt_ch_fgetconvs)                                    \
   NEOMUTT_TEST_ITEM(test_mutt_ch_get_default_charset)                          \
   NEOMUTT_TEST_ITEM(test_mutt_ch_get_langinfo_charset)                         \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv)                                        \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_close)                                  \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_lookup)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_open)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_ch_lookup_add)                                   \
@@ -316,6 +320,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_pattern_comp)                                    \
   NEOMUTT_TEST_ITEM(test_mutt_regex_compile)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_regex_free)                                      \
+  NEOMUTT_TEST_ITEM(test_mutt_regex_literal)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_regexlist_add)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_regexlist_free)                                  \
   NEOMUTT_TEST_ITEM(test_mutt_regexlist_match)                                 \
@@ -329,6 +334,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_replacelist_new)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_replacelist_remove)                              \
   NEOMUTT_TEST_ITEM(test_rfc2047_decode)                                       \
+  NEOMUTT_TEST_ITEM(test_rfc2047_decode_cleanup)                               \
   NEOMUTT_TEST_ITEM(test_rfc2047_decode_addrlist)                              \
   NEOMUTT_TEST_ITEM(test_rfc2047_decode_envelope)                              \
   NEOMUTT_TEST_ITEM(test_rfc2047_encode)                                       \
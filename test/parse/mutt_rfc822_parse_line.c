@@ -60,4 +60,73 @@ void test_mutt_rfc822_parse_line(void)
     TEST_CHECK(mutt_rfc822_parse_line(&envelope, &email, "apple", NULL, false,
                                       false, false) == 0);
   }
+
+  {
+    // Header names are matched ignoring case
+    static const char *names[] = { "Subject", "subject", "SUBJECT", "sUbJeCt" };
+    for (size_t i = 0; i < mutt_array_size(names); i++)
+    {
+      struct Envelope *env = mutt_env_new();
+      char line[32];
+      char value[] = "apple";
+      mutt_str_strfcpy(line, names[i], sizeof(line));
+      TEST_CHECK(mutt_rfc822_parse_line(env, NULL, line, value, false, false, false) == 1);
+      TEST_MSG("Name: %s", names[i]);
+      TEST_CHECK(mutt_str_strcmp(env->subject, "apple") == 0);
+      mutt_env_free(&env);
+    }
+  }
+
+  {
+    // Every header is recognised
+    static const char *names[] = {
+      "Apparently-From", "Apparently-To", "Bcc", "Cc", "Content-Description",
+      "Content-Disposition", "Content-Language", "Content-Length",
+      "Content-Transfer-Encoding", "Content-Type", "Date", "From",
+      "In-Reply-To", "Lines", "List-Post", "Mail-Followup-To", "Mail-Reply-To",
+      "Message-ID", "MIME-Version", "References", "Reply-To", "Return-Path",
+      "Sender", "Status", "Subject", "To", "X-Label", "X-Original-To", "X-Status",
+    };
+    for (size_t i = 0; i < mutt_array_size(names); i++)
+    {
+      struct Email *e = mutt_email_new();
+      e->content = mutt_body_new();
+      struct Envelope *env = mutt_env_new();
+      char line[32];
+      char value[] = "<apple@example.com>";
+      mutt_str_strfcpy(line, names[i], sizeof(line));
+      TEST_CHECK(mutt_rfc822_parse_line(env, e, line, value, false, false, false) == 1);
+      TEST_MSG("Name: %s", names[i]);
+      mutt_env_free(&env);
+      mutt_email_free(&e);
+    }
+  }
+
+  {
+    // Names that are close to a known header, aren't recognised
+    static const char *names[] = {
+      "Subjec", "Subjects", "Sbject", "Tx", "T", "Ccc", "Content-", "Content-Types",
+      "Mail-", "X-Labels", "Dote", "Xyz", "-", "Apparently-Tx",
+    };
+    for (size_t i = 0; i < mutt_array_size(names); i++)
+    {
+      struct Envelope *env = mutt_env_new();
+      char line[32];
+      char value[] = "apple";
+      mutt_str_strfcpy(line, names[i], sizeof(line));
+      TEST_CHECK(mutt_rfc822_parse_line(env, NULL, line, value, false, false, false) == 0);
+      TEST_MSG("Name: %s", names[i]);
+      mutt_env_free(&env);
+    }
+  }
+
+  {
+    // Unknown headers are kept, if asked
+    struct Envelope *env = mutt_env_new();
+    char line[] = "X-Fruit\0apple";
+    TEST_CHECK(mutt_rfc822_parse_line(env, NULL, line, line + 8, true, false, false) == 0);
+    struct ListNode *np = STAILQ_FIRST(&env->userhdrs);
+    TEST_CHECK(np && (mutt_str_strcmp(np->data, "X-Fruit:apple") == 0));
+    mutt_env_free(&env);
+  }
 }
@@ -27,6 +27,33 @@
 #include "address/lib.h"
 #include "email/lib.h"
 
+/**
+ * read_lines - Read all the header lines from a string
+ * @param str     String to read
+ * @param len     Length of the string
+ * @param linelen Initial size of the line buffer
+ * @param out     Buffer for the lines, each followed by a '|'
+ * @retval num Offset of the end of the headers
+ */
+static long read_lines(const char *str, size_t len, size_t linelen, struct Buffer *out)
+{
+  FILE *fp = fmemopen((void *) str, len, "r");
+  if (!fp)
+    return -1;
+
+  char *line = mutt_mem_malloc(linelen);
+  while (*(line = mutt_rfc822_read_line(fp, line, &linelen)) != '\0')
+  {
+    mutt_buffer_addstr(out, line);
+    mutt_buffer_addch(out, '|');
+  }
+  const long offset = ftell(fp);
+
+  FREE(&line);
+  fclose(fp);
+  return offset;
+}
+
 void test_mutt_rfc822_read_line(void)
 {
   // char *mutt_rfc822_read_line(FILE *fp, char *line, size_t *linelen);
@@ -46,4 +73,70 @@ void test_mutt_rfc822_read_line(void)
     FILE fp = { 0 };
     TEST_CHECK(!mutt_rfc822_read_line(&fp, "apple", NULL));
   }
+
+  {
+    // Lines are unfolded and trailing space removed
+    static const char *tests[][2] = {
+      { "From: a@b\nTo: c@d\n\nbody\n", "From: a@b|To: c@d|" },
+      { "Subject: apple\n  banana\n\tcherry\n\n", "Subject: apple banana cherry|" },
+      { "Subject: apple  \r\n \t banana \r\n\r\n", "Subject: apple banana|" },
+      { "Subject: apple\n \n cherry\n\n", "Subject: apple cherry|" },
+      { "Subject: apple\n", "Subject: apple|" },
+      { "Subject: apple", "" },
+      { "Subject: apple\n banana", "" },
+      { "\nSubject: apple\n", "" },
+      { " Subject: apple\n", "" },
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      struct Buffer *buf = mutt_buffer_new();
+      read_lines(tests[i][0], strlen(tests[i][0]), 8, buf);
+      TEST_CHECK(mutt_str_strcmp(mutt_b2s(buf), tests[i][1]) == 0);
+      TEST_MSG("Expected: %s", tests[i][1]);
+      TEST_MSG("Actual  : %s", mutt_b2s(buf));
+      mutt_buffer_free(&buf);
+    }
+  }
+
+  {
+    // The blank line at the end of the headers is consumed
+    struct Buffer *buf = mutt_buffer_new();
+    const char *str = "From: a@b\n\nbody\n";
+    TEST_CHECK(read_lines(str, strlen(str), 256, buf) == 11);
+    mutt_buffer_free(&buf);
+  }
+
+  {
+    // The rest of a line containing a NUL is ignored
+    struct Buffer *buf = mutt_buffer_new();
+    const char str[] = "To: a@b\nSubject: apple\0banana\n\n";
+    read_lines(str, sizeof(str) - 1, 256, buf);
+    TEST_CHECK(mutt_str_strcmp(mutt_b2s(buf), "To: a@b|Subject: apple|") == 0);
+    TEST_MSG("Actual: %s", mutt_b2s(buf));
+    mutt_buffer_free(&buf);
+  }
+
+  {
+    // A very long line, and a line folded many times
+    struct Buffer *in = mutt_buffer_new();
+    struct Buffer *out = mutt_buffer_new();
+    mutt_buffer_addstr(in, "X-Long: ");
+    for (int i = 0; i < 10000; i++)
+      mutt_buffer_addstr(in, "apple ");
+    mutt_buffer_addstr(in, "\nReferences:");
+    for (int i = 0; i < 10000; i++)
+      mutt_buffer_add_printf(in, "\n\t<%d@example.com>", i);
+    mutt_buffer_addstr(in, "\n\n");
+
+    read_lines(mutt_b2s(in), mutt_buffer_len(in), 16, out);
+    const char *s = mutt_b2s(out);
+    TEST_CHECK(mutt_buffer_len(out) == (8 + 60000 - 1 + 1) + (11 + 188890 + 1));
+    TEST_MSG("Length: %zu", mutt_buffer_len(out));
+    TEST_CHECK(mutt_str_startswith(s, "X-Long: apple apple", CASE_MATCH) != 0);
+    TEST_CHECK(strstr(s, "apple|References: <0@example.com> <1@example.com>") != NULL);
+    TEST_CHECK(strstr(s, "<9999@example.com>|") != NULL);
+    mutt_buffer_free(&in);
+    mutt_buffer_free(&out);
+  }
 }
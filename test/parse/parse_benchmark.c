@@ -0,0 +1,169 @@
+/**
+ * @file
+ * Benchmark for the header parser
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "acutest.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mutt/mutt.h"
+#include "address/lib.h"
+#include "email/lib.h"
+
+/* Not part of the unit tests; build and run it with: make benchmark */
+
+/**
+ * elapsed - Time since a starting point
+ * @param start Starting point
+ * @retval num Seconds
+ */
+static double elapsed(const struct timespec *start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + ((now.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/**
+ * parse_all - Parse every header in a buffer
+ * @param name Name of the benchmark
+ * @param buf  Headers, each ending with a blank line
+ * @param num  Number of headers expected
+ * @retval num Number of headers with a Subject
+ */
+static int parse_all(const char *name, struct Buffer *buf, int num)
+{
+  FILE *fp = fmemopen(buf->data, mutt_buffer_len(buf), "r");
+  if (!TEST_CHECK(fp != NULL))
+    return 0;
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  int count = 0;
+  int subjects = 0;
+  while (ftell(fp) < (long) mutt_buffer_len(buf))
+  {
+    struct Email *e = mutt_email_new();
+    e->env = mutt_rfc822_read_header(fp, e, true, false);
+    if (e->env->subject)
+      subjects++;
+    mutt_email_free(&e);
+    count++;
+  }
+
+  TEST_CHECK_(count == num, "%s: %zu bytes, %d headers, %.3fs", name,
+              mutt_buffer_len(buf), count, elapsed(&start));
+  fclose(fp);
+  return subjects;
+}
+
+void test_parse_benchmark(void)
+{
+  C_Charset = "utf-8";
+
+  {
+    // Typical headers
+    struct Buffer *buf = mutt_buffer_alloc(8 * 1024 * 1024);
+    const int num = 5000;
+    for (int i = 0; i < num; i++)
+    {
+      mutt_buffer_add_printf(
+          buf,
+          "Return-Path: <sender%d@example.com>\n"
+          "Received: from mail%d.example.com (mail%d.example.com [192.0.2.1])\n"
+          "\tby mx.example.org (Postfix) with ESMTPS id %X\n"
+          "\tfor <user@example.org>; Mon, 1 Jan 2018 00:00:00 +0000\n"
+          "Received: from localhost (localhost [127.0.0.1])\n"
+          "\tby mail%d.example.com (Postfix) with ESMTP id %X;\n"
+          "\tMon, 1 Jan 2018 00:00:00 +0000\n"
+          "DKIM-Signature: v=1; a=rsa-sha256; c=relaxed/relaxed; d=example.com;\n"
+          "\ts=mail; t=1514764800; bh=47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU=;\n"
+          "\th=From:To:Subject:Date; b=dGhpcyBpcyBub3QgYSByZWFsIHNpZ25hdHVyZQ==\n"
+          "From: Sender %d <sender%d@example.com>\n"
+          "To: User <user@example.org>\n"
+          "Cc: list@example.org\n"
+          "Subject: =?utf-8?q?Message_number_%d?=\n"
+          "Date: Mon, 1 Jan 2018 00:00:00 +0000\n"
+          "Message-ID: <%d@example.com>\n"
+          "In-Reply-To: <%d@example.com>\n"
+          "References: <%d@example.com>\n"
+          "\t<%d@example.com>\n"
+          "MIME-Version: 1.0\n"
+          "Content-Type: text/plain; charset=utf-8\n"
+          "Content-Transfer-Encoding: quoted-printable\n"
+          "X-Mailer: Benchmark 1.0\n"
+          "List-Post: <mailto:list@example.org>\n"
+          "Status: RO\n"
+          "\n",
+          i, i, i, i, i, i, i, i, i, i, i - 1, i - 2, i - 1);
+    }
+    TEST_CHECK(parse_all("typical", buf, num) == num);
+    mutt_buffer_free(&buf);
+  }
+
+  {
+    // A header folded many times
+    struct Buffer *buf = mutt_buffer_alloc(4 * 1024 * 1024);
+    mutt_buffer_addstr(buf, "Subject: apple\nReferences:");
+    for (int i = 0; i < 100000; i++)
+      mutt_buffer_add_printf(buf, "\n <%d@example.com>", i);
+    mutt_buffer_addstr(buf, "\n\n");
+    TEST_CHECK(parse_all("folded", buf, 1) == 1);
+    mutt_buffer_free(&buf);
+  }
+
+  {
+    // A very long line
+    struct Buffer *buf = mutt_buffer_alloc(4 * 1024 * 1024);
+    mutt_buffer_addstr(buf, "Subject: apple\nX-Long: ");
+    for (int i = 0; i < 200000; i++)
+      mutt_buffer_addstr(buf, "banana ");
+    mutt_buffer_addstr(buf, "\n\n");
+    TEST_CHECK(parse_all("long", buf, 1) == 1);
+    mutt_buffer_free(&buf);
+  }
+
+  {
+    // Many headers that are nearly, but not quite, known
+    static const char *names[] = {
+      "Subjects", "Sbject",  "Tx",    "Ccc",       "Content-Types", "Dates",
+      "Mail-To",  "X-Label2", "Froms", "Reference", "Reply-Too",     "Lines-",
+    };
+    struct Buffer *buf = mutt_buffer_alloc(4 * 1024 * 1024);
+    const int num = 500;
+    for (int i = 0; i < num; i++)
+    {
+      mutt_buffer_addstr(buf, "Subject: apple\n");
+      for (int j = 0; j < 50; j++)
+        mutt_buffer_add_printf(buf, "%s: %d\n", names[j % mutt_array_size(names)], j);
+      mutt_buffer_addstr(buf, "\n");
+    }
+    TEST_CHECK(parse_all("unknown", buf, num) == num);
+    mutt_buffer_free(&buf);
+  }
+}
+
+TEST_LIST = {
+  { "test_parse_benchmark", test_parse_benchmark },
+  { 0 },
+};
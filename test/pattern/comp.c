@@ -784,5 +784,70 @@ void test_mutt_pattern_comp(void)
     mutt_pattern_free(&pat);
   }
 
+  { /* a plain, lower-case regex is compiled as a string match */
+    char *s = "~s foobar";
+
+    mutt_buffer_reset(err);
+    struct PatternHead *pat = mutt_pattern_comp(s, 0, err);
+
+    if (!TEST_CHECK(pat != NULL))
+    {
+      TEST_MSG("Expected: pat != NULL");
+      TEST_MSG("Actual  : pat == NULL");
+    }
+
+    struct PatternHead expected;
+    SLIST_INIT(&expected);
+    struct Pattern e = { .op = MUTT_PAT_SUBJECT,
+                         .not = 0,
+                         .alladdr = 0,
+                         .stringmatch = 1,
+                         .groupmatch = 0,
+                         .ign_case = 1,
+                         .isalias = 0,
+                         .ismulti = 0,
+                         .min = 0,
+                         .max = 0,
+                         .p.str = "foobar" };
+    SLIST_INSERT_HEAD(&expected, &e, entries);
+
+    if (!TEST_CHECK(!cmp_pattern(pat, &expected)))
+    {
+      char s2[1024];
+      canonical_pattern(s2, &expected, 0);
+      TEST_MSG("Expected:\n%s", s2);
+      canonical_pattern(s2, pat, 0);
+      TEST_MSG("Actual:\n%s", s2);
+    }
+
+    mutt_pattern_free(&pat);
+  }
+
+  { /* anything else stays a regex */
+    char *strs[] = { "~s foo.bar", "~s Foobar", "~t ^foo", "~x foobar" };
+
+    for (size_t i = 0; i < mutt_array_size(strs); i++)
+    {
+      mutt_buffer_reset(err);
+      struct PatternHead *pat = mutt_pattern_comp(strs[i], 0, err);
+
+      if (!TEST_CHECK(pat != NULL))
+      {
+        TEST_MSG("Expected: pat != NULL");
+        TEST_MSG("Actual  : pat == NULL");
+        continue;
+      }
+
+      if (!TEST_CHECK(SLIST_FIRST(pat)->stringmatch == 0))
+      {
+        TEST_MSG("Pattern : %s", strs[i]);
+        TEST_MSG("Expected: stringmatch == 0");
+        TEST_MSG("Actual  : stringmatch == 1");
+      }
+
+      mutt_pattern_free(&pat);
+    }
+  }
+
   mutt_buffer_free(&err);
 }
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Test code for mutt_regex_literal()
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include "mutt/mutt.h"
+
+struct LiteralTest
+{
+  const char *regex;
+  int flags;
+  const char *literal;
+};
+
+void test_mutt_regex_literal(void)
+{
+  // size_t mutt_regex_literal(const char *str, int flags, char *buf, size_t buflen);
+
+  {
+    char buf[32] = { 0 };
+    TEST_CHECK(mutt_regex_literal(NULL, 0, buf, sizeof(buf)) == 0);
+  }
+
+  {
+    TEST_CHECK(mutt_regex_literal("apple", 0, NULL, 32) == 0);
+  }
+
+  {
+    char buf[32] = { 0 };
+    TEST_CHECK(mutt_regex_literal("apple", 0, buf, 0) == 0);
+  }
+
+  {
+    static const struct LiteralTest tests[] = {
+      // clang-format off
+      { "ERROR",                  0,         "ERROR" },
+      { "https?://[^ ]+",         0,         "http"  },
+      { "^\\+.*",                 0,         "+"     },
+      { "^@@ -[0-9]+ @@",         0,         "@@ -"  },
+      { "x\\.y",                  0,         "x.y"   },
+      { "ab*cd",                  0,         "cd"    },
+      { "a{0,2}bc",               0,         "bc"    },
+      { "abc+d",                  0,         "abc"   },
+      { "[]abc]xyz",              0,         "xyz"   },
+      { "[[:alpha:]]+ing",        0,         "ing"   },
+      { "(foo|bar)baz",           0,         "baz"   },
+      { "\\<(foo|bar)\\>",        0,         ""      },
+      { "foo|bar",                0,         ""      },
+      { "foo\\|bar",              0,         ""      },
+      { "\\w+ed",                 0,         "ed"    },
+      { "\\`abc\\'",              0,         "abc"   },
+      { "caf\xc3\xa9s",           0,         "caf"   },
+      { "mistake",                REG_ICASE, "ta"    },
+      { "warning",                REG_ICASE, "warn"  },
+      { "",                       0,         ""      },
+      // clang-format on
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      char buf[32] = { 0 };
+      TEST_CASE(tests[i].regex);
+      size_t len = mutt_regex_literal(tests[i].regex, tests[i].flags, buf, sizeof(buf));
+      TEST_CHECK(len == strlen(tests[i].literal));
+      TEST_CHECK(strncmp(buf, tests[i].literal, len) == 0);
+      TEST_MSG("Expected: '%s'", tests[i].literal);
+      TEST_MSG("Actual:   '%.*s'", (int) len, buf);
+    }
+  }
+
+  {
+    // A short buffer gets a prefix of the text
+    char buf[4] = { 0 };
+    size_t len = mutt_regex_literal("abcdefgh*", 0, buf, sizeof(buf));
+    TEST_CHECK(len == 4);
+    TEST_CHECK(strncmp(buf, "abcd", 4) == 0);
+  }
+
+  {
+    // Every match must contain the text
+    static const char *regexes[] = {
+      "ERROR", "https?://[^ ]+", "ab*c", "^-.*", "x+y?z", "(a|b)c{2}d", "[0-9]+\\.[0-9]*",
+    };
+    static const char *strings[] = {
+      "ERROR: 404", "see http://x.org", "ac", "abbbc", "-- ", "xxz", "bccd", "3.", "x", "",
+    };
+
+    for (size_t i = 0; i < mutt_array_size(regexes); i++)
+    {
+      regex_t rx;
+      TEST_CASE(regexes[i]);
+      if (!TEST_CHECK(REG_COMP(&rx, regexes[i], 0) == 0))
+        continue;
+
+      char buf[32];
+      size_t len = mutt_regex_literal(regexes[i], 0, buf, sizeof(buf));
+      TEST_CHECK(len > 0);
+      buf[len] = '\0';
+      for (size_t j = 0; j < mutt_array_size(strings); j++)
+      {
+        if (regexec(&rx, strings[j], 0, NULL, 0) == 0)
+        {
+          TEST_CHECK(strstr(strings[j], buf) != NULL);
+          TEST_MSG("'%s' matches, but doesn't contain '%s'", strings[j], buf);
+        }
+      }
+      regfree(&rx);
+    }
+  }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Test code for rfc2047_decode_cleanup()
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <locale.h>
+#include "mutt/mutt.h"
+#include "email/lib.h"
+
+void test_rfc2047_decode_cleanup(void)
+{
+  // void rfc2047_decode_cleanup(void);
+
+  {
+    rfc2047_decode_cleanup();
+    TEST_CHECK_(1, "rfc2047_decode_cleanup()");
+  }
+
+  if (!TEST_CHECK((setlocale(LC_ALL, "en_US.UTF-8") != NULL) ||
+                  (setlocale(LC_ALL, "C.UTF-8") != NULL)))
+  {
+    TEST_MSG("Cannot set locale to (en_US|C).UTF-8");
+    return;
+  }
+
+  {
+    // Remembered results depend on $charset
+    C_Charset = "utf-8";
+    char *s = mutt_str_strdup("=?iso-8859-1?q?caf=E9?=");
+    rfc2047_decode(&s);
+    TEST_CHECK(mutt_str_strcmp(s, "caf\xc3\xa9") == 0);
+    FREE(&s);
+
+    C_Charset = "iso-8859-1";
+    s = mutt_str_strdup("=?iso-8859-1?q?caf=E9?=");
+    rfc2047_decode(&s);
+    TEST_CHECK(mutt_str_strcmp(s, "caf\xc3\xa9") != 0);
+    TEST_MSG("Got: %s", s);
+    FREE(&s);
+
+    C_Charset = "utf-8";
+    rfc2047_decode_cleanup();
+  }
+}